@@ -177,8 +177,7 @@ void mexFunction(int nlhs, mxArray *plhs[],
 			
 	  if (state < 0 || state > numStates-1)
 	    mexErrMsgTxt("State is out of range.");
-	  probabilities =
-	    vector< vector<double > >(soln.getGame().getProbabilities()[state]);
+	  probabilities = soln.getGame().getProbabilities(state);
 			
 	  plhs[0] = mxCreateDoubleMatrix(probabilities.size(),
 					 probabilities[0].size(),mxREAL);
@@ -0,0 +1,176 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+//! Benchmark for the active set of the endogenous max-min-max sweep
+//! @example
+
+#include "sgrisksharing.hpp"
+#include <random>
+
+// Contribution game on an n by n grid of contributions in [0,1]. Each
+// player gets b times the other's contribution less its own, less a
+// small random cost, so most stage payoffs are interior. Transitions
+// depend only on the state.
+SGGame contributionGame(int numStates, int n, double delta)
+{
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> unif(0,1);
+
+  vector< vector<int> > numActions(numStates,vector<int>(2,n));
+  vector< vector< vector<double> > >
+    payoffs(numStates,vector< vector<double> >(n*n,vector<double>(2)));
+  vector< vector< vector<double> > >
+    probabilities(numStates,vector< vector<double> >(n*n));
+  for (int state = 0; state < numStates; state++)
+    {
+      vector<double> row(numStates);
+      double total = 0;
+      for (int sp = 0; sp < numStates; sp++)
+	total += (row[sp] = unif(gen));
+      for (int sp = 0; sp < numStates; sp++)
+	row[sp] /= total;
+
+      const double b = 2.0+state;
+      for (int a = 0; a < n*n; a++)
+	{
+	  const double a0 = static_cast<double>(a%n)/(n-1);
+	  const double a1 = static_cast<double>(a/n)/(n-1);
+	  payoffs[state][a][0] = b*a1-a0-0.05*unif(gen);
+	  payoffs[state][a][1] = b*a0-a1-0.05*unif(gen);
+	  probabilities[state][a] = row;
+	}
+    }
+
+  return SGGame(delta,numStates,numActions,payoffs,probabilities,
+		vector< vector<bool> >(),vector<bool>(2,false));
+} // contributionGame
+
+// Polygon cut out of a large box by the half spaces of the last
+// iteration in the given state.
+vector<SGPoint> finalPolygon(const SGSolution_MaxMinMax & soln, int state)
+{
+  vector<SGPoint> poly = {SGPoint(-1e3,-1e3),SGPoint(1e3,-1e3),
+			  SGPoint(1e3,1e3),SGPoint(-1e3,1e3)};
+  for (const SGStep & step : soln.getIterations().back().getSteps())
+    {
+      const SGPoint & normal = step.getHyperplane().getNormal();
+      const double level = step.getHyperplane().getLevels()[state];
+      vector<SGPoint> clipped;
+      for (int k = 0; k < poly.size(); k++)
+	{
+	  const SGPoint & p = poly[k];
+	  const SGPoint & q = poly[(k+1)%poly.size()];
+	  const double fp = normal*p-level, fq = normal*q-level;
+	  if (fp <= 0)
+	    clipped.push_back(p);
+	  if ((fp < 0 && fq > 0) || (fq < 0 && fp > 0))
+	    clipped.push_back(p+(fp/(fp-fq))*(q-p));
+	}
+      poly.swap(clipped);
+    }
+  return poly;
+} // finalPolygon
+
+// Largest difference between the support functions of the final
+// correspondences, over a fine grid of directions.
+double supportDistance(const vector< vector<SGPoint> > & polys0,
+		       const vector< vector<SGPoint> > & polys1)
+{
+  const int numDirs = 3600;
+  double dist = 0;
+  for (int state = 0; state < polys0.size(); state++)
+    {
+      for (int k = 0; k < numDirs; k++)
+	{
+	  const SGPoint dir(cos(2.0*PI*k/numDirs),sin(2.0*PI*k/numDirs));
+	  double h0 = -numeric_limits<double>::max(), h1 = h0;
+	  for (const SGPoint & p : polys0[state])
+	    h0 = std::max(h0,dir*p);
+	  for (const SGPoint & p : polys1[state])
+	    h1 = std::max(h1,dir*p);
+	  dist = std::max(dist,abs(h0-h1));
+	}
+    }
+  return dist;
+} // supportDistance
+
+int main ()
+{
+  // Risk sharing, where every consumption split is on the frontier,
+  // and a contribution game, where most actions are never optimal.
+  const vector< pair<string,SGGame> > games
+    = {{"risksharing",
+	SGGame(RiskSharingGame(0.7,5,20,0,RiskSharingGame::Consumption))},
+       {"contribution",contributionGame(3,50,0.8)}};
+
+  cout << setw(14) << "game"
+       << setw(10) << "activeset"
+       << setw(8) << "iters"
+       << setw(12) << "time (s)"
+       << setw(10) << "speedup"
+       << setw(14) << "policy acts"
+       << setw(11) << "activated"
+       << setw(10) << "resweeps"
+       << setw(12) << "distance" << endl;
+
+  for (const pair<string,SGGame> & game : games)
+    {
+      vector< vector<SGPoint> > fullPolys;
+      double fullTime = 0;
+      for (bool activeSet : {false,true})
+	{
+	  SGEnv env;
+	  env.setParam(SG::STOREITERATIONS,1);
+	  env.setParam(SG::ERRORTOL,1e-8);
+	  env.setParam(SG::ACTIVESET,activeSet);
+
+	  SGSolver_MaxMinMax solver(env,game.second);
+	  auto start = std::chrono::steady_clock::now();
+	  solver.solve();
+	  auto end = std::chrono::steady_clock::now();
+	  const double time = std::chrono::duration<double>(end-start).count();
+
+	  const SGSolution_MaxMinMax & soln = solver.getSolution();
+	  vector< vector<SGPoint> > polys(game.second.getNumStates());
+	  for (int state = 0; state < game.second.getNumStates(); state++)
+	    polys[state] = finalPolygon(soln,state);
+	  if (!activeSet)
+	    {
+	      fullPolys = polys;
+	      fullTime = time;
+	    }
+
+	  const SGPruningStats & stats = solver.getPruningStats();
+	  cout << setw(14) << game.first
+	       << setw(10) << activeSet
+	       << setw(8) << solver.getNumIterations()
+	       << setw(12) << setprecision(4) << time
+	       << setw(10) << setprecision(3) << fullTime/time
+	       << setw(14) << stats.policyActions
+	       << setw(11) << stats.actionsActivated
+	       << setw(10) << stats.arcsResweeps
+	       << setw(12) << setprecision(3) << supportDistance(polys,fullPolys)
+	       << endl;
+	}
+    }
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+
+//! Benchmark for adaptive direction refinement in the 3-player solver
+//! @example
+
+#include "sgrisksharing_3player.hpp"
+#include "sgsolver_maxminmax_3player.hpp"
+
+//! Gap between the outer and inner approximations of the final iteration
+/*! The outer approximation is the intersection of the half spaces of
+    the last iteration, and the inner approximation is the convex hull
+    of its pivots, which are attained payoffs. Returns the largest
+    difference between their support functions over the test
+    directions and states. The outer support function in direction u
+    is the smallest \f$\sum_k \lambda_k l_k\f$ over \f$\lambda\ge 0\f$
+    with \f$\sum_k \lambda_k d_k = u\f$, which is computed by trying
+    every three of the normals closest to u. */
+double approximationGap(const SGSolution_MaxMinMax & soln,
+			const vector<SGPoint> & testDirs,
+			int numStates)
+{
+  vector<SGPoint> normals;
+  vector< vector<double> > levels;
+  vector<SGTuple> pivots;
+  for (const SGStep & step : soln.getIterations().back().getSteps())
+    {
+      normals.push_back(step.getHyperplane().getNormal());
+      normals.back() /= normals.back().norm();
+      levels.push_back(step.getHyperplane().getLevels());
+      pivots.push_back(step.getPivot());
+    }
+
+  const int numNearest = std::min<int>(12,normals.size());
+  double gap = 0;
+  for (const SGPoint & u : testDirs)
+    {
+      vector<int> nearest(normals.size());
+      for (int k = 0; k < nearest.size(); k++)
+	nearest[k] = k;
+      std::partial_sort(nearest.begin(),nearest.begin()+numNearest,nearest.end(),
+			[&](int k0, int k1)
+			{ return normals[k0]*u > normals[k1]*u; });
+
+      for (int state = 0; state < numStates; state++)
+	{
+	  double inner = -std::numeric_limits<double>::max();
+	  for (const SGTuple & pivot : pivots)
+	    inner = std::max(inner,pivot[state]*u);
+
+	  double outer = std::numeric_limits<double>::max();
+	  for (int i = 0; i < numNearest; i++)
+	    for (int j = i+1; j < numNearest; j++)
+	      for (int k = j+1; k < numNearest; k++)
+		{
+		  // Solve lambda_i d_i + lambda_j d_j + lambda_k d_k = u
+		  // by Cramer's rule.
+		  const SGPoint & di = normals[nearest[i]];
+		  const SGPoint & dj = normals[nearest[j]];
+		  const SGPoint & dk = normals[nearest[k]];
+		  const double det = SGPoint::cross(di,dj)*dk;
+		  if (abs(det) < 1e-12)
+		    continue;
+		  const double li = SGPoint::cross(u,dj)*dk/det;
+		  const double lj = SGPoint::cross(di,u)*dk/det;
+		  const double lk = SGPoint::cross(di,dj)*u/det;
+		  if (li < 0 || lj < 0 || lk < 0)
+		    continue;
+		  outer = std::min(outer,(li*levels[nearest[i]][state]
+					  +lj*levels[nearest[j]][state]
+					  +lk*levels[nearest[k]][state]));
+		}
+	  if (outer < std::numeric_limits<double>::max())
+	    gap = std::max(gap,outer-inner);
+	}
+    }
+  return gap;
+}
+
+int main ()
+{
+  RiskSharingGame_3Player rg(0.6,3,3);
+  SGGame game(rg);
+
+  std::mt19937 generator(0);
+  std::normal_distribution<double> normDistr(0.0,1.0);
+  vector<SGPoint> testDirs(1000,SGPoint(3,0.0));
+  for (SGPoint & dir : testDirs)
+    {
+      for (int p = 0; p < 3; p++)
+	dir[p] = normDistr(generator);
+      dir /= dir.norm();
+    }
+
+  cout << setw(10) << "mode"
+       << setw(12) << "max dirs"
+       << setw(12) << "final dirs"
+       << setw(12) << "iters"
+       << setw(12) << "time (s)"
+       << setw(12) << "gap" << endl;
+
+  struct Run { bool adaptive; int numDirs; };
+  for (Run run : {Run{false,100},Run{false,200},Run{false,300},
+	Run{true,100},Run{true,200},Run{true,300}})
+    {
+      SGEnv env;
+      env.setParam(SG::ERRORTOL,1e-6);
+      env.setParam(SG::STOREITERATIONS,1);
+      env.setParam(SG::ADAPTIVEDIRECTIONS,run.adaptive);
+
+      SGSolver_MaxMinMax_3Player solver(env,game);
+
+      // The solver reports its progress on cout.
+      std::stringstream progress;
+      std::streambuf * coutBuf = cout.rdbuf(progress.rdbuf());
+      auto start = std::chrono::steady_clock::now();
+      // Redundant directions are kept, so that every direction counts
+      // towards the budget in both modes.
+      solver.solve(run.numDirs,false,false);
+      auto end = std::chrono::steady_clock::now();
+      cout.rdbuf(coutBuf);
+      const double time = std::chrono::duration<double>(end-start).count();
+
+      int numIter = 0;
+      string line;
+      while (std::getline(progress,line))
+	numIter += (line.compare(0,5,"Iter:") == 0);
+
+      // The last iteration has a step for every direction and one
+      // for each threat direction.
+      const SGSolution_MaxMinMax & soln = solver.getSolution();
+      cout << setw(10) << (run.adaptive ? "adaptive" : "uniform")
+	   << setw(12) << run.numDirs
+	   << setw(12) << soln.getIterations().back().getSteps().size()-3
+	   << setw(12) << numIter
+	   << setw(12) << setprecision(4) << time
+	   << setw(12) << setprecision(3)
+	   << approximationGap(soln,testDirs,game.getNumStates()) << endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+//! Benchmark for the coarse-to-fine direction schedule of solve_fixed
+//! @example
+
+#include "sgrisksharing.hpp"
+
+int main ()
+{
+  cout << setw(8) << "delta"
+       << setw(12) << "endowments"
+       << setw(10) << "coarse"
+       << setw(10) << "iters"
+       << setw(12) << "time (s)"
+       << setw(10) << "speedup"
+       << setw(14) << "distance" << endl;
+
+  for (double delta : {0.7,0.85,0.95})
+    {
+      for (int numEndowments : {2,5})
+	{
+	  RiskSharingGame rsg(delta,numEndowments,20,0,
+			      RiskSharingGame::Consumption);
+	  SGGame game(rsg);
+
+	  SGLevelMatrix fineLevels;
+	  double fineTime = 0;
+	  for (int coarse : {0,8,16,52})
+	    {
+	      SGEnv env;
+	      env.setParam(SG::STOREITERATIONS,1);
+	      env.setParam(SG::ERRORTOL,1e-8);
+	      env.setParam(SG::COARSEDIRECTIONS,coarse);
+
+	      SGSolver_MaxMinMax solver(env,game);
+	      auto start = std::chrono::steady_clock::now();
+	      solver.solve_fixed();
+	      auto end = std::chrono::steady_clock::now();
+	      const double time = std::chrono::duration<double>(end-start).count();
+
+	      // Every schedule ends with the same directions, so the
+	      // final levels can be compared direction by direction.
+	      SGLevelMatrix levels(2,game.getNumStates());
+	      for (const SGStep & step : solver.getSolution().getIterations().back().getSteps())
+		levels.push_back(step.getHyperplane().getNormal(),
+				 step.getHyperplane().getLevels());
+	      if (coarse == 0)
+		{
+		  fineLevels = levels;
+		  fineTime = time;
+		}
+
+	      double distance = 0;
+	      for (int d = 0; d < levels.size(); d++)
+		for (int state = 0; state < game.getNumStates(); state++)
+		  distance = std::max(distance,abs(levels.level(d,state)
+						   -fineLevels.level(d,state)));
+
+	      // solve_fixed leaves cout in scientific notation
+	      cout << resetiosflags(ios::floatfield)
+		   << setw(8) << delta
+		   << setw(12) << numEndowments
+		   << setw(10) << coarse
+		   << setw(10) << solver.getNumIterations()
+		   << setw(12) << setprecision(4) << time
+		   << setw(10) << setprecision(3) << fineTime/time
+		   << setw(14) << setprecision(3) << distance << endl;
+	    }
+	}
+    }
+
+  return 0;
+}
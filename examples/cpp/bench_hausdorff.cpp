@@ -0,0 +1,98 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+//! Micro-benchmark for the pseudo-Hausdorff error estimator
+//! @example
+
+#include "sg.hpp"
+
+// Directions clustered around the circle in the way the endogenous
+// max-min-max sweep generates them, with levels that move slightly
+// between revolutions.
+void randomLevels(SGLevelMatrix & levels, int numDirections,
+		  std::mt19937 & gen, double noise)
+{
+  std::uniform_real_distribution<double> unif(0.0,1.0);
+  vector<double> angles(numDirections);
+  for (int d = 0; d < numDirections; d++)
+    angles[d] = 2.0*PI*unif(gen);
+  std::sort(angles.begin(),angles.end());
+
+  vector<double> dirLevels(levels.getNumStates());
+  for (int d = 0; d < numDirections; d++)
+    {
+      SGPoint dir(cos(angles[d]),sin(angles[d]));
+      for (int s = 0; s < dirLevels.size(); s++)
+	dirLevels[s] = cos(angles[d]-s)+noise*unif(gen);
+      levels.push_back(dir,dirLevels);
+    }
+} // randomLevels
+
+int main ()
+{
+  const int numStates = 2;
+  std::mt19937 gen(0);
+
+  cout << setw(8) << "n"
+       << setw(16) << "brute (ms)"
+       << setw(16) << "sorted (ms)"
+       << setw(10) << "speedup"
+       << setw(8) << "equal" << endl;
+
+  int crossover = -1;
+  for (int n = 8; n <= 4096; n *= 2)
+    {
+      SGLevelMatrix oldLevels(2,numStates), newLevels(2,numStates);
+      randomLevels(oldLevels,n,gen,1e-3);
+      randomLevels(newLevels,n,gen,1e-3);
+
+      // Repeat so that each measurement takes a few milliseconds.
+      const int reps = std::max(1,(1<<22)/(n*n));
+
+      double bruteValue = 0, fastValue = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < reps; r++)
+	bruteValue += SGLevelMatrix::pseudoHausdorff_bruteForce(newLevels,oldLevels);
+      auto mid = std::chrono::steady_clock::now();
+      for (int r = 0; r < reps; r++)
+	fastValue += SGLevelMatrix::pseudoHausdorff(newLevels,oldLevels);
+      auto end = std::chrono::steady_clock::now();
+
+      double bruteTime = std::chrono::duration<double,std::milli>(mid-start).count()/reps;
+      double fastTime = std::chrono::duration<double,std::milli>(end-mid).count()/reps;
+
+      if (crossover < 0 && fastTime < bruteTime)
+	crossover = n;
+
+      cout << setw(8) << n
+	   << setw(16) << setprecision(6) << bruteTime
+	   << setw(16) << setprecision(6) << fastTime
+	   << setw(10) << setprecision(3) << bruteTime/fastTime
+	   << setw(8) << (bruteValue == fastValue ? "yes" : "NO") << endl;
+    }
+
+  if (crossover > 0)
+    cout << "Sorted search is faster from n=" << crossover << endl;
+  else
+    cout << "Brute force is faster for all n tested" << endl;
+
+  return 0;
+}
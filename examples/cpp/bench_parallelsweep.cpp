@@ -0,0 +1,172 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+//! Benchmark for the parallel endogenous max-min-max sweep
+//! @example
+
+#include "sgrisksharing.hpp"
+#include <thread>
+
+// Polygon cut out of a large box by the half spaces of the last
+// iteration in the given state.
+vector<SGPoint> finalPolygon(const SGSolution_MaxMinMax & soln, int state)
+{
+  vector<SGPoint> poly = {SGPoint(-1e3,-1e3),SGPoint(1e3,-1e3),
+			  SGPoint(1e3,1e3),SGPoint(-1e3,1e3)};
+  for (const SGStep & step : soln.getIterations().back().getSteps())
+    {
+      const SGPoint & normal = step.getHyperplane().getNormal();
+      const double level = step.getHyperplane().getLevels()[state];
+      vector<SGPoint> clipped;
+      for (int k = 0; k < poly.size(); k++)
+	{
+	  const SGPoint & p = poly[k];
+	  const SGPoint & q = poly[(k+1)%poly.size()];
+	  const double fp = normal*p-level, fq = normal*q-level;
+	  if (fp <= 0)
+	    clipped.push_back(p);
+	  if ((fp < 0 && fq > 0) || (fq < 0 && fp > 0))
+	    clipped.push_back(p+(fp/(fp-fq))*(q-p));
+	}
+      poly.swap(clipped);
+    }
+  return poly;
+} // finalPolygon
+
+// Largest difference between the support functions of the final
+// correspondences, over a fine grid of directions.
+double supportDistance(const vector< vector<SGPoint> > & polys0,
+		       const vector< vector<SGPoint> > & polys1)
+{
+  const int numDirs = 3600;
+  double dist = 0;
+  for (int state = 0; state < polys0.size(); state++)
+    {
+      for (int k = 0; k < numDirs; k++)
+	{
+	  const SGPoint dir(cos(2.0*PI*k/numDirs),sin(2.0*PI*k/numDirs));
+	  double h0 = -numeric_limits<double>::max(), h1 = h0;
+	  for (const SGPoint & p : polys0[state])
+	    h0 = std::max(h0,dir*p);
+	  for (const SGPoint & p : polys1[state])
+	    h1 = std::max(h1,dir*p);
+	  dist = std::max(dist,abs(h0-h1));
+	}
+    }
+  return dist;
+} // supportDistance
+
+// Largest difference between the directions and levels of the last
+// iterations, or infinity if they have different numbers of
+// directions.
+double directionDistance(const SGSolution_MaxMinMax & soln0,
+			 const SGSolution_MaxMinMax & soln1)
+{
+  const list<SGStep> & steps0 = soln0.getIterations().back().getSteps();
+  const list<SGStep> & steps1 = soln1.getIterations().back().getSteps();
+  if (steps0.size() != steps1.size())
+    return numeric_limits<double>::infinity();
+
+  double dist = 0;
+  for (auto s0 = steps0.cbegin(), s1 = steps1.cbegin();
+       s0 != steps0.cend(); ++s0, ++s1)
+    {
+      const SGHyperplane & h0 = s0->getHyperplane();
+      const SGHyperplane & h1 = s1->getHyperplane();
+      dist = std::max(dist,SGPoint::distance(h0.getNormal(),h1.getNormal()));
+      for (int state = 0; state < h0.getLevels().size(); state++)
+	dist = std::max(dist,abs(h0.getLevels()[state]-h1.getLevels()[state]));
+    }
+  return dist;
+} // directionDistance
+
+// The optional argument is the largest number of threads, which
+// defaults to the number of hardware threads.
+int main (int argc, char ** argv)
+{
+  RiskSharingGame rsg(0.7,5,20,0,RiskSharingGame::Consumption);
+  SGGame game(rsg);
+
+  const int hardwareThreads
+    = std::max(1,static_cast<int>(std::thread::hardware_concurrency()));
+  const int maxThreads = (argc > 1? std::max(1,atoi(argv[1])) : hardwareThreads);
+  cout << "Hardware threads: " << hardwareThreads << endl;
+
+  cout << setw(10) << "segments"
+       << setw(10) << "threads"
+       << setw(14) << "time (s)"
+       << setw(10) << "speedup"
+       << setw(8) << "iters"
+       << setw(8) << "dirs"
+       << setw(10) << "restarts"
+       << setw(14) << "dir. dist."
+       << setw(14) << "distance" << endl;
+
+  vector< vector<SGPoint> > serialPolys;
+  SGSolution_MaxMinMax serialSoln;
+  double serialTime = 0;
+  for (int segments : {0,4,8,16})
+    {
+      for (int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+	  if (segments == 0 && threads > 1)
+	    break;
+
+	  SGEnv env;
+	  env.setParam(SG::STOREITERATIONS,1);
+	  env.setParam(SG::ERRORTOL,1e-8);
+	  env.setParam(SG::SWEEPSEGMENTS,segments);
+	  env.setParam(SG::NUMTHREADS,threads);
+
+	  SGSolver_MaxMinMax solver(env,game);
+	  auto start = std::chrono::steady_clock::now();
+	  solver.solve();
+	  auto end = std::chrono::steady_clock::now();
+	  const double time = std::chrono::duration<double>(end-start).count();
+
+	  const SGSolution_MaxMinMax & soln = solver.getSolution();
+	  vector< vector<SGPoint> > polys(game.getNumStates());
+	  for (int state = 0; state < game.getNumStates(); state++)
+	    polys[state] = finalPolygon(soln,state);
+	  if (segments == 0)
+	    {
+	      serialPolys = polys;
+	      serialSoln = soln;
+	      serialTime = time;
+	    }
+
+	  const double distance = supportDistance(polys,serialPolys);
+	  const double dirDistance = directionDistance(soln,serialSoln);
+
+	  cout << setw(10) << segments
+	       << setw(10) << threads
+	       << setw(14) << setprecision(4) << time
+	       << setw(10) << setprecision(3) << serialTime/time
+	       << setw(8) << solver.getNumIterations()
+	       << setw(8) << soln.getIterations().back().getSteps().size()
+	       << setw(10) << solver.getPruningStats().arcsRestarts
+	       << setw(14) << setprecision(3) << dirDistance
+	       << setw(14) << setprecision(3) << distance << endl;
+	}
+    }
+
+  return 0;
+}
@@ -75,8 +75,36 @@ void SGAction_MaxMinMax::resetTrimmedPoints(const SGPoint & payoffUB)
       dir[(p+2)%numPlayers] = 1;
       trimmedBndryDirs[p].push_back(dir);
     }
+
+  if (trimmedLowerBounds.size() != numPlayers)
+    {
+      trimmedLowerBounds = SGTuple(numPlayers,SGPoint(3,0.0));
+      trimmedUpperBounds = SGTuple(numPlayers,SGPoint(3,0.0));
+    }
+  for (int p = 0; p < numPlayers; p++)
+    updateTrimmedBounds(p);
 } // resetTrimmedPoints
 
+void SGAction_MaxMinMax::updateTrimmedBounds(int player)
+{
+  const SGTuple & polygon = trimmedPoints[player];
+  if (polygon.size() == 0)
+    return;
+
+  SGPoint & lower = trimmedLowerBounds[player];
+  SGPoint & upper = trimmedUpperBounds[player];
+  lower = polygon[0];
+  upper = polygon[0];
+  for (int k = 1; k < polygon.size(); k++)
+    {
+      for (int i = 0; i < 3; i++)
+	{
+	  lower[i] = std::min(lower[i],polygon[k][i]);
+	  upper[i] = std::max(upper[i],polygon[k][i]);
+	}
+    }
+} // updateTrimmedBounds
+
 
 bool SGAction_MaxMinMax::trim(const SGPoint& normal,
 			      double level)
@@ -101,12 +129,29 @@ bool SGAction_MaxMinMax::trim(const SGPoint& normal,
 	  if (trimmedPoints[player].size()==0)
 	    continue;
 
+	  // Most half spaces contain the whole polygon. Check first
+	  // whether they contain its bounding box. Each term bounds
+	  // the corresponding term of the dot product with any vertex,
+	  // and the terms are summed in the same order as in
+	  // SGPoint::operator*, so the test is exact in floating
+	  // point.
+	  const SGPoint & lower = trimmedLowerBounds[player];
+	  const SGPoint & upper = trimmedUpperBounds[player];
+	  double boxLevel = 0;
+	  for (int i = 0; i < 3; i++)
+	    boxLevel += std::max(lower[i]*normal[i],upper[i]*normal[i]);
+	  if (boxLevel < level-tol.icTol)
+	    continue;
+
 	  if (intersectPolygonHalfSpace(normal,
 					level,
 					player,
 					trimmedPoints[player],
 					trimmedBndryDirs[player]))
-	    tf = true;
+	    {
+	      tf = true;
+	      updateTrimmedBounds(player);
+	    }
 	}
     }
   return tf;
@@ -169,21 +214,21 @@ bool SGAction_MaxMinMax::intersectHalfSpace(const SGPoint& normal,
       double l0 = normal * segment[0];
       double l1 = normal * segment[1];
       
-      if (l0 > level + env->getParam(SG::ICTOL)
-	  && l1 > level + env->getParam(SG::ICTOL))
+      if (l0 > level + tol.icTol
+	  && l1 > level + tol.icTol)
 	{
 	  // Both lie above the ray.
 	  // cout << "Warning: No binding IC Payoffs for (s,a)=(" << state << "," << action << ")" << endl;
 	  segment.clear();
 	  segmentDirs.clear();
 	}
-      else if (l0 < level+env->getParam(SG::ICTOL)
-	       && l1 < level+env->getParam(SG::ICTOL))
+      else if (l0 < level+tol.icTol
+	       && l1 < level+tol.icTol)
 	{
 	  // Leave points alone.
 	  return false;
 	}
-      else if (abs(l0 - l1)>env->getParam(SG::INTERSECTTOL))
+      else if (abs(l0 - l1)>tol.intersectTol)
 	{
 	  // Can take intersection.
 	  //double weightOn1 = max(0.0,min((level - l0)/(l1 - l0),1.0));
@@ -232,31 +277,62 @@ bool SGAction_MaxMinMax::intersectPolygonHalfSpace(const SGPoint & normal,
 {
   assert(numPlayers == 3);
 
-  if (extPnts.size() == 0)
+  const int n = extPnts.size();
+  if (n == 0)
     return false;
-  
-  // Iterate to find a point inside the half space.
-  int k0 = 0; 
-  int k1, k2;
-  double l0;
-  for (k0 = 0; k0 < extPnts.size(); k0++)
+
+  // Classify every vertex in one pass. The levels and classes live
+  // on the stack unless the polygon is unusually large.
+  const int inlineVertices = 32;
+  double levelBuffer[inlineVertices];
+  char classBuffer[inlineVertices];
+  vector<double> levelHeap;
+  vector<char> classHeap;
+  double * levels = levelBuffer;
+  char * classes = classBuffer;
+  if (n > inlineVertices)
+    {
+      levelHeap.resize(n);
+      classHeap.resize(n);
+      levels = levelHeap.data();
+      classes = classHeap.data();
+    }
+
+  // Conditions for being considered "inside" are that either (a)
+  // the point itself is below the hyperplane or (b) the point is on
+  // the hyperplane but the boundary direction points below or (c)
+  // the boundary direction points above and if we substitute in the
+  // normal for this point, the new boundary direction would point
+  // above the old normal. Conditions for being considered "outside"
+  // are that either (a) the point itself is above the hyperplane or
+  // (b) the point is on the hyperplane but the boundary direction
+  // points outside. Because of rounding, a point very close to
+  // level+/-icTol can be neither.
+  const char inside = 1, outside = 2;
+  int numInside = 0, numOutside = 0;
+  for (int k = 0; k < n; k++)
     {
-      l0 = extPnts[k0] * normal;
-      k1 = (k0+1+extPnts.size())%extPnts.size();
-
-      // Conditions for being considered "inside" are that either (a)
-      // the point itself is below the hyperplane or (b) the point is
-      // on the hyperplane but the boundary direction points below or
-      // (c) the boundary direction points above and if we substitute
-      // in the normal for this point, the new boundary direction
-      // would point above the old normal.
-      if (l0 < level-env->getParam(SG::ICTOL)
-	  || (abs(l0-level) <= env->getParam(SG::ICTOL)
-	      && (SGPoint::cross(extPntDirs[k0],extPntDirs[k1])*normal < env->getParam(SG::ICTOL) ) ) )
-  	break;
+      const double l = extPnts[k] * normal;
+      levels[k] = l;
+      classes[k] = 0;
+      if (abs(l-level) <= tol.icTol)
+	{
+	  const double turn = SGPoint::cross(extPntDirs[k],
+					     extPntDirs[(k+1)%n])*normal;
+	  if (l < level-tol.icTol || turn < tol.icTol)
+	    classes[k] |= inside;
+	  if (l > level+tol.icTol || turn >= tol.icTol)
+	    classes[k] |= outside;
+	}
+      else if (l < level-tol.icTol)
+	classes[k] = inside;
+      else if (l > level+tol.icTol)
+	classes[k] = outside;
+      numInside += ((classes[k] & inside) != 0);
+      numOutside += ((classes[k] & outside) != 0);
     }
 
-  if (k0 == extPnts.size())
+  if (numInside == 0)
     {
       // Whole set is ouside the half space.
       extPnts.clear();
@@ -264,53 +340,30 @@ bool SGAction_MaxMinMax::intersectPolygonHalfSpace(const SGPoint & normal,
       return true;
     }
 
-  // Now keep iterating to find a point outside the half space;
-  double l1;
-  for (k1 = (k0+1)%extPnts.size();
-       k1 != k0;
-       k1 = (k1+1)%extPnts.size())
-    {
-      l1 = extPnts[k1] * normal;
-      k2 = (k1+1+extPnts.size())%extPnts.size();
-
-      // Conditions for being considered "outside" are that either (a)
-      // the point itself is above the hyperplane or (b) the point is
-      // on the hyperplane but the boundary direction points outside
-      // and if we substitute in the normal for the previous bounding
-      // direction, the new boundary direction would point above the
-      // old normal.
-      if (l1 > level+env->getParam(SG::ICTOL)
-	  || (abs(l1-level) <= env->getParam(SG::ICTOL)
-	      && (SGPoint::cross(extPntDirs[k1],extPntDirs[k2])*normal >= env->getParam(SG::ICTOL) ) ) )
-  	break;
-    }
+  // Find the first point inside the half space (k0), and then the
+  // first point after it that is outside (k1).
+  int k0, k1;
+  for (k0 = 0; !(classes[k0] & inside); k0++) ;
+  for (k1 = (k0+1)%n; k1 != k0 && !(classes[k1] & outside); k1 = (k1+1)%n) ;
 
-  if (k1 == k0)
+  if (numOutside == 0 || k1 == k0)
     {
       // Whole set is inside the half space. Do nothing.
       return false;
     }
+  const double l1 = levels[k1];
 
   // Remaining case is that there is at least one point (k0) that is
   // inside and one point (k1) outside the half space. Move k0 so that
   // it is the first point inside after k1.
-  for (k0 = (k1+1)%extPnts.size();
-       k0 != k1;
-       k0 = (k0+1)%extPnts.size())
-    {
-      l0 = extPnts[k0] * normal;
-      k2 = (k0+1+extPnts.size())%extPnts.size();
-      if (l0 < level-env->getParam(SG::ICTOL)
-	  || (abs(l0-level) <= env->getParam(SG::ICTOL)
-	      && (SGPoint::cross(extPntDirs[k0],extPntDirs[k2])*normal < env->getParam(SG::ICTOL) ) ) )
-  	break;
-    }
+  for (k0 = (k1+1)%n; k0 != k1 && !(classes[k0] & inside); k0 = (k0+1)%n) ;
+  const double l0 = levels[k0];
 
   // add two new points for the intersections.
   bool tf = true;
   
-  int k = (k1-1+extPnts.size())%extPnts.size(); // The inside point just before k1
-  double l = extPnts[k] * normal;
+  int k = (k1-1+n)%n; // The inside point just before k1
+  double l = levels[k];
   double weight1 = 0.0, weight0 = 0.0;
   if (abs(l1-l)>1e-12)
     {
@@ -323,8 +376,8 @@ bool SGAction_MaxMinMax::intersectPolygonHalfSpace(const SGPoint & normal,
     }
   SGPoint intersection1 = weight1*extPnts[k1]+(1.0-weight1)*extPnts[k];
 
-  k = (k0-1+extPnts.size())%extPnts.size(); // The outside point just before k0
-  l = extPnts[k] * normal;
+  k = (k0-1+n)%n; // The outside point just before k0
+  l = levels[k];
   if (abs(l0-l)>1e-12)
     {
       weight0 = max(0.0,min((level-l)/(l0-l),1.0));
@@ -339,44 +392,63 @@ bool SGAction_MaxMinMax::intersectPolygonHalfSpace(const SGPoint & normal,
   assert(!intersection1.anyNaN());
   assert(!intersection0.anyNaN());
 
-  // Replace k1 (which is outside) with the intersection between k1 and k1-1
-  extPnts[k1] = intersection1;
-
-  // if (weight==0.0)
-  //      extPntDirs[k1] = normal;
-
-  // Now have to insert intersection0 and delete points that are
-  // outside the half space.
-  if (k==k1)
+  // Rebuild the polygon in one pass, Sutherland-Hodgman style. The
+  // points from k0 up to k1-1 are kept, k1 becomes intersection1 and
+  // intersection0 (with the new boundary direction normal) follows
+  // it. Points are written in the order they would have after
+  // replacing, inserting, and erasing in place, so the result is
+  // identical. The output goes to an inline buffer first; copying
+  // it back only touches storage the tuple already has, except when
+  // the polygon gains a vertex.
+  const int numKept = (k1-k0+n)%n;
+  const int m = numKept + 2;
+  SGPoint pntBuffer[inlineVertices+1], dirBuffer[inlineVertices+1];
+  vector<SGPoint> pntHeap, dirHeap;
+  SGPoint * newPnts = pntBuffer;
+  SGPoint * newDirs = dirBuffer;
+  if (m > inlineVertices+1)
     {
-      // There was only one point outside, which was k1. Then we have
-      // to insert a new point.
-      extPnts.emplace(k0,intersection0);
-      extPntDirs.emplace(k0,normal);
+      pntHeap.resize(m);
+      dirHeap.resize(m);
+      newPnts = pntHeap.data();
+      newDirs = dirHeap.data();
     }
-  else
+
+  int out = 0;
+  for (int i = 0; i < n; i++)
     {
-      // There is more than one point outside. Replace point at k with
-      // intersection0.
-      extPnts[k] = intersection0;
-      extPntDirs[k] = normal;
-
-      // Delete points strictly after k1 and strictly before k (which are
-      // all outside)
-      if (k1<k)
-  	{
-  	  extPnts.erase(k1+1,k);
-  	  extPntDirs.erase(k1+1,k);
-  	}
-      else // k0>k1
-  	{
-  	  extPnts.erase(k1+1,extPnts.size());
-  	  extPnts.erase(0,k);
-  	  extPntDirs.erase(k1+1,extPntDirs.size());
-  	  extPntDirs.erase(0,k);
-  	}
+      if (k==k1 && i==k0)
+	{
+	  // Only k1 was outside, so intersection0 is inserted before
+	  // k0.
+	  newPnts[out] = intersection0;
+	  newDirs[out++] = normal;
+	}
+      if ((i-k0+n)%n < numKept)
+	{
+	  newPnts[out] = extPnts[i];
+	  newDirs[out++] = extPntDirs[i];
+	}
+      else if (i==k1)
+	{
+	  newPnts[out] = intersection1;
+	  newDirs[out++] = extPntDirs[k1];
+	}
+      else if (i==k)
+	{
+	  newPnts[out] = intersection0;
+	  newDirs[out++] = normal;
+	}
     }
+  assert(out == m);
 
+  extPnts.resize(m);
+  extPntDirs.resize(m);
+  for (int i = 0; i < m; i++)
+    {
+      extPnts[i] = newPnts[i];
+      extPntDirs[i] = newDirs[i];
+    }
 
   return tf;
 } // intersectPolygonHalfSpace
@@ -406,39 +478,7 @@ double SGAction_MaxMinMax::calculateMinIC(int action,int state,int player,
 					  const SGGame & game,
 					  const SGTuple & threatTuple)
 {
-  vector<int> playersActions, playersDeviations;
-  int deviation, deviationIndex;
-  double currentGains;
-
-  double tmpMinIC = -numeric_limits<double>::max();
-
-  indexToVector(action,playersActions,
-		game.getNumActions()[state]);
-  playersDeviations = playersActions;
-
-  assert(state<game.getPayoffs().size());
-  assert(action<game.getPayoffs()[state].size());
-  
-  for (deviation = 0;
-       deviation < game.getNumActions()[state][player];
-       deviation++)
-    {
-      playersDeviations[player] = deviation;
-
-      deviationIndex = vectorToIndex(playersDeviations,
-				     game.getNumActions()[state]);
-      currentGains 
-	= (1-game.getDelta())/game.getDelta() 
-	* (game.getPayoffs()[state][deviationIndex][player] 
-	   - game.getPayoffs()[state][action][player])
-	+ threatTuple.expectation(game.getProbabilities()[state][deviationIndex], 
-				  player);
-
-      if (currentGains > tmpMinIC)
-	tmpMinIC = currentGains;
-    } // deviation
-
-  return tmpMinIC;
+  return game.minICPayoff(state,action,player,threatTuple);
 }  // calculateMinIC
 
 bool operator==(const SGAction_MaxMinMax & lhs,
@@ -479,3 +519,24 @@ bool SGAction_MaxMinMax::supportable() const
       return true;
   return false;
 }
+
+int eraseUnsupportable(vector<SGAction_MaxMinMax> & actions)
+{
+  auto last = std::remove_if(actions.begin(),actions.end(),
+			     [](const SGAction_MaxMinMax & action)
+			     { return !action.supportable(); });
+  int numRemoved = actions.end()-last;
+  actions.erase(last,actions.end());
+  return numRemoved;
+} // eraseUnsupportable
+
+SGActionID findAction(const vector<SGAction_MaxMinMax> & actions,
+		      int action)
+{
+  auto it = std::lower_bound(actions.begin(),actions.end(),action,
+			     [](const SGAction_MaxMinMax & a, int index)
+			     { return a.getAction() < index; });
+  if (it == actions.end() || it->getAction() != action)
+    return -1;
+  return it - actions.begin();
+} // findAction
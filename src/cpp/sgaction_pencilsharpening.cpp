@@ -152,36 +152,7 @@ double SGAction_PencilSharpening::calculateMinIC(int action,int state,int player
 				                  const SGGame & game,
 				                  const SGTuple & threatTuple)
 {
-  vector<int> playersActions, playersDeviations;
-  int deviation, deviationIndex;
-  double currentGains;
-
-  double minIC = -numeric_limits<double>::max();
-
-  indexToVector(action,playersActions,
-		game.getNumActions()[state]);
-  playersDeviations = playersActions;
-  
-  for (deviation = 0;
-       deviation < game.getNumActions()[state][player];
-       deviation++)
-    {
-      playersDeviations[player] = deviation;
-
-      deviationIndex = vectorToIndex(playersDeviations,
-				     game.getNumActions()[state]);
-      currentGains 
-	= (1-game.getDelta())/game.getDelta() 
-	* (game.getPayoffs()[state][deviationIndex][player] 
-	   - game.getPayoffs()[state][action][player])
-	+ threatTuple.expectation(game.getProbabilities()[state][deviationIndex], 
-				  player);
-
-      if (currentGains > minIC)
-	minIC = currentGains;
-    } // deviation
-
-  return minIC;
+  return game.minICPayoff(state,action,player,threatTuple);
 }
 
 void SGAction_PencilSharpening::calculateBindingContinuations(const vector<bool> & updatedThreatTuple,
@@ -211,9 +182,7 @@ void SGAction_PencilSharpening::calculateBindingContinuations(const vector<bool>
       tuples[player].clear(); 
       points[player].clear(); 
 	      
-      nextPoint = extremeTuples.back()
-	.expectation(game.getProbabilities()
-		     [state][action]);
+      nextPoint = game.expectation(extremeTuples.back(),state,action);
 
       for (tuple = extremeTuples.rbegin(),
 	     nextTuple = tuple+1,
@@ -223,8 +192,7 @@ void SGAction_PencilSharpening::calculateBindingContinuations(const vector<bool>
 	   ++tuple,++nextTuple, --tupleIndex)
 	{
 	  point = nextPoint;
-	  nextPoint = nextTuple->expectation(game.getProbabilities()
-					     [state][action]);
+	  nextPoint = game.expectation(*nextTuple,state,action);
 
 	  double gap = point[player] - nextPoint[player];
 	  if ( abs(gap) < env.getParam(SG::FLATTOL)
@@ -287,7 +255,7 @@ void SGAction_PencilSharpening::calculateBindingContinuations(const vector<bool>
 		}
 
 	      SGPoint expPivot 
-		= pivot.expectation(game.getProbabilities()[state][getAction()]);
+		= game.expectation(pivot,state,getAction());
 	      intersectRaySegment(expPivot,currentDirection,player);
 	    }
 	  // Otherwise, not IC.
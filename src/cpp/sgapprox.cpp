@@ -204,7 +204,7 @@ void SGApprox::findBestDirection()
 	{
 	  SG::Regime bestBindingRegime = SG::Binding;
 
-	  SGPoint expPivot = pivot.expectation(game.getProbabilities()[state][action->getAction()]);
+	  SGPoint expPivot = game.expectation(pivot,state,action->getAction());
 	  SGPoint stagePayoff = game.getPayoffs()[state][action->getAction()];
 	  SGPoint nonBindingPayoff = (1-delta) * stagePayoff + delta * expPivot;
 	  SGPoint nonBindingDirection = nonBindingPayoff - pivot[state];
@@ -295,8 +295,9 @@ void SGApprox::findBestDirection()
 			  int nextPoint = action->getTuples()[player][point];
 			  while (nextPoint < extremeTuples.size())
 			    {
-			      SGPoint newExpContVal = extremeTuples[nextPoint]
-				.expectation(game.getProbabilities()[state][action->getAction()]);
+			      SGPoint newExpContVal
+				= game.expectation(extremeTuples[nextPoint],
+						   state,action->getAction());
 			      SGPoint nextDirection = (1-delta)*stagePayoff
 				+ delta*newExpContVal
 				- pivot[state];
@@ -511,7 +512,7 @@ void SGApprox::calculateNewPivot()
 	{
 	  SGPoint tempPayoff( (1-delta)
 			      *game.getPayoffs()[state][actionTuple[state]->getAction()] 
-			      +delta*pivot.expectation(game.getProbabilities()[state][actionTuple[state]->getAction()]) );
+			      +delta*game.expectation(pivot,state,actionTuple[state]->getAction()) );
 	  
 	  assert( SGPoint::distance(tempPayoff, pivot[state]) < 1e-8 );
 	  if ( SGPoint::distance(tempPayoff, pivot[state]) > 1e-5 )
@@ -562,7 +563,7 @@ double SGApprox::updatePivot(vector<double> & movements,
       for (int statep = 0; statep < numStates; statep++)
 	{
 	  tempChange[state] += delta* 
-	    game.getProbabilities()[state][actionTuple[state]->getAction()][statep]
+	    game.getProbability(state,actionTuple[state]->getAction(),statep)
 	    * changes[statep];
 	}
     }
@@ -786,7 +787,7 @@ void SGApprox::trimBindingContinuations()
 	  // Check if the line starting from pivot towards direction
 	  // cuts any of the intersection lines.
 	  expPivot 
-	    = pivot.expectation(game.getProbabilities()[state][action->getAction()]);
+	    = game.expectation(pivot,state,action->getAction());
 
 	  action->trim(expPivot,currentDirection);
 
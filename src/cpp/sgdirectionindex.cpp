@@ -0,0 +1,172 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#include "sgdirectionindex.hpp"
+
+SGDirectionIndex::SGDirectionIndex(const SGLevelMatrix & levels):
+  dimension(levels.getNumPlayers())
+{
+  vector<SGPoint> dirs(levels.size());
+  vector<int> order(levels.size());
+  for (int d = 0; d < levels.size(); d++)
+    {
+      dirs[d] = levels.getDirection(d);
+      order[d] = d;
+    }
+
+  nodes.reserve(dirs.size());
+  if (!dirs.empty())
+    build(dirs,order,0,dirs.size());
+} // constructor
+
+int SGDirectionIndex::build(const vector<SGPoint> & dirs,
+			    vector<int> & order,
+			    int begin, int end)
+{
+  // Split on the coordinate with the largest spread.
+  int axis = 0;
+  double maxSpread = -1;
+  for (int i = 0; i < dimension; i++)
+    {
+      double lo = dirs[order[begin]][i], hi = lo;
+      for (int k = begin+1; k < end; k++)
+	{
+	  lo = std::min(lo,dirs[order[k]][i]);
+	  hi = std::max(hi,dirs[order[k]][i]);
+	}
+      if (hi-lo > maxSpread)
+	{
+	  maxSpread = hi-lo;
+	  axis = i;
+	}
+    }
+
+  // Directions before the median have coordinates that are less
+  // than or equal to it, and directions after it greater than or
+  // equal.
+  const int mid = begin+(end-begin)/2;
+  std::nth_element(order.begin()+begin,order.begin()+mid,order.begin()+end,
+		   [&](int d0, int d1)
+		   {
+		     return (dirs[d0][axis] < dirs[d1][axis]
+			     || (dirs[d0][axis] == dirs[d1][axis] && d0 < d1));
+		   });
+
+  const int node = nodes.size();
+  nodes.push_back(Node());
+  nodes[node].dir = dirs[order[mid]];
+  nodes[node].id = order[mid];
+  nodes[node].axis = axis;
+  nodes[node].left = (mid > begin ? build(dirs,order,begin,mid) : -1);
+  nodes[node].right = (mid+1 < end ? build(dirs,order,mid+1,end) : -1);
+  return node;
+} // build
+
+int SGDirectionIndex::insert(const SGPoint & dir)
+{
+  if (dimension == 0)
+    dimension = dir.size();
+  assert(dir.size() == dimension);
+
+  Node newNode;
+  newNode.dir = dir;
+  newNode.id = nodes.size();
+  newNode.axis = 0;
+  newNode.left = -1;
+  newNode.right = -1;
+
+  if (!nodes.empty())
+    {
+      // Descend to a leaf, going right on ties as build() does.
+      int node = 0;
+      while (true)
+	{
+	  const int axis = nodes[node].axis;
+	  int & child = (dir[axis] < nodes[node].dir[axis]
+			 ? nodes[node].left : nodes[node].right);
+	  if (child < 0)
+	    {
+	      child = nodes.size();
+	      newNode.axis = (axis+1)%dimension;
+	      break;
+	    }
+	  node = child;
+	}
+    }
+  nodes.push_back(newNode);
+  return newNode.id;
+} // insert
+
+int SGDirectionIndex::nearest(const SGPoint & dir) const
+{
+  int best = -1;
+  double bestDist = std::numeric_limits<double>::max();
+  if (!nodes.empty())
+    nearest(0,dir,best,bestDist);
+  return best;
+} // nearest
+
+void SGDirectionIndex::nearest(int node, const SGPoint & dir,
+			       int & best, double & bestDist) const
+{
+  const Node & n = nodes[node];
+  const SGPoint diff = n.dir-dir;
+  const double dist = diff*diff;
+  if (dist < bestDist
+      || (dist == bestDist && n.id < best))
+    {
+      best = n.id;
+      bestDist = dist;
+    }
+
+  // Search the side of the split containing dir first. The other
+  // side is at least as far as the split itself.
+  const double axisDiff = dir[n.axis]-n.dir[n.axis];
+  const int nearChild = (axisDiff < 0 ? n.left : n.right);
+  const int farChild = (axisDiff < 0 ? n.right : n.left);
+  if (nearChild >= 0)
+    nearest(nearChild,dir,best,bestDist);
+  if (farChild >= 0 && axisDiff*axisDiff <= bestDist)
+    nearest(farChild,dir,best,bestDist);
+} // nearest
+
+bool SGDirectionIndex::contains(const SGPoint & dir, double distance) const
+{
+  if (nodes.empty())
+    return false;
+
+  vector<int> stack(1,0);
+  while (!stack.empty())
+    {
+      const Node & n = nodes[stack.back()];
+      stack.pop_back();
+      if (SGPoint::distance(n.dir,dir) < distance)
+	return true;
+
+      const double axisDiff = dir[n.axis]-n.dir[n.axis];
+      if (n.left >= 0 && axisDiff < distance)
+	stack.push_back(n.left);
+      if (n.right >= 0 && -axisDiff < distance)
+	stack.push_back(n.right);
+    }
+  return false;
+} // contains
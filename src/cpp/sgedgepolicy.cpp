@@ -28,7 +28,13 @@ SGEdgePolicy::SGEdgePolicy(const SGProductPolicy & _master):
 {
   int s;
   for (s = 0; s < master.numStates(); s++)
-    policies[s] = master.getPolicies(s).cbegin();
+    {
+      // A state without policies has no edges.
+      if (master.getPolicies(s).empty())
+	throw(SGException(SG::NOEDGES));
+      policies[s] = master.getPolicies(s).cbegin();
+      baseKey.toggle(policies[s]->getKey());
+    }
     
   for (s = 0; s < master.numStates(); s++)
     {
@@ -53,13 +59,14 @@ bool SGEdgePolicy::incrementBasePolicy()
     {
       // Try to increment the policy in this state. If unable to, keep
       // going down. 
-      if (++policies[state] != master.getPolicies(state).cend())
+      if (policies[state]+1 != master.getPolicies(state).cend())
 	{
 	  // We were able to increment the policy. Now set the
 	  // policies in higher states back to the beginning.
+	  setPolicy(state,policies[state]+1);
 	  while (++state < master.numStates())
 	    {
-	      policies[state] = master.getPolicies(state).cbegin();
+	      setPolicy(state,master.getPolicies(state).cbegin());
 	    }
 
 	  // Finally, reset the substitution.
@@ -96,16 +103,3 @@ bool SGEdgePolicy::operator++()
 {
   return (incrementSubPolicy() || incrementBasePolicy() );
 } // operator++
-
-std::string SGEdgePolicy::hash() const
-{
-  std::string str("E_"); // for "Edge"
-  for (int s = 0; s < policies.size(); s++)
-    {
-      str += policies[s]->hash();
-    }
-  str += "_sub";
-  str += subPolicy->hash();
-
-  return str;
-}
@@ -36,6 +36,9 @@ void SGEnv::restoreDefaults()
   intParams[SG::TUPLERESERVESIZE] = 1e4;
   intParams[SG::MAXPOLICYITERATIONS] = 1e2;
   intParams[SG::STOREITERATIONS] = 2;
+  intParams[SG::NUMTHREADS] = 1;
+  intParams[SG::SWEEPSEGMENTS] = 0;
+  intParams[SG::COARSEDIRECTIONS] = 0;
 
   doubleParams[SG::ERRORTOL] = 1e-8;
   doubleParams[SG::DIRECTIONTOL] = 1e-11;
@@ -61,6 +64,8 @@ void SGEnv::restoreDefaults()
   boolParams[SG::PRINTTOCOUT] = true;
   boolParams[SG::CHECKSUFFICIENT] = true;
   boolParams[SG::STOREACTIONS] = true;
+  boolParams[SG::ACTIVESET] = false;
+  boolParams[SG::ADAPTIVEDIRECTIONS] = false;
 
   // setOStream(cout);
 }
@@ -114,3 +119,22 @@ int SGEnv::getParam(SG::INT_PARAM param) const
       throw(SGException(SG::UNKNOWN_PARAM));
   return intParams[param];
 } // getParam
+
+SGEnvSnapshot::SGEnvSnapshot(const SGEnv & env):
+  errorTol(env.getParam(SG::ERRORTOL)),
+  policyIterTol(env.getParam(SG::POLICYITERTOL)),
+  icTol(env.getParam(SG::ICTOL)),
+  normTol(env.getParam(SG::NORMTOL)),
+  improveTol(env.getParam(SG::IMPROVETOL)),
+  intersectTol(env.getParam(SG::INTERSECTTOL)),
+  subGenFactor(env.getParam(SG::SUBGENFACTOR)),
+  lexImproveTol(env.getParam(SG::LEXIMPROVETOL)),
+  lexSubOpTol(env.getParam(SG::LEXSUBOPTOL)),
+  maxIterations(env.getParam(SG::MAXITERATIONS)),
+  maxPolicyIterations(env.getParam(SG::MAXPOLICYITERATIONS)),
+  storeIterations(env.getParam(SG::STOREITERATIONS)),
+  sweepSegments(env.getParam(SG::SWEEPSEGMENTS)),
+  coarseDirections(env.getParam(SG::COARSEDIRECTIONS)),
+  activeSet(env.getParam(SG::ACTIVESET)),
+  adaptiveDirections(env.getParam(SG::ADAPTIVEDIRECTIONS))
+{}
@@ -0,0 +1,32 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#include "sgexpectationcache.hpp"
+
+SGExpectationCache::SGExpectationCache(const SGGame & _game):
+  game(_game),
+  points(_game.getNumTransitionRows()),
+  penalties(_game.getNumTransitionRows(),0.0),
+  pointStamps(_game.getNumTransitionRows(),0),
+  penaltyStamps(_game.getNumTransitionRows(),0),
+  generation(1)
+{}
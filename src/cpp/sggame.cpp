@@ -20,6 +20,10 @@
 // Chicago, IL
 
 #include "sggame.hpp"
+#include <map>
+#include <unordered_map>
+
+const double SGGame::maxSparseDensity = 0.25;
 
 SGGame::SGGame(const SGAbstractGame & game):
   numPlayers(game.getNumPlayers()),
@@ -28,7 +32,7 @@ SGGame::SGGame(const SGAbstractGame & game):
   numActions(game.getNumActions()),
   numActions_total(numStates,1),
   payoffs(numStates),
-  probabilities(numStates),
+  sparseTransitions(true),
   eqActions(numStates),
   unconstrained(numPlayers)
 {
@@ -41,14 +45,16 @@ SGGame::SGGame(const SGAbstractGame & game):
 	numActions_total[state] *= numActions[state][p];
       
       payoffs[state] = vector<SGPoint>(numActions_total[state],SGPoint(numPlayers,0.0));
-      probabilities[state] = vector< vector<double> >(numActions_total[state],
-						      vector<double> (numStates,0));
+      // Compress one state at a time, so that the dense transitions
+      // of the whole game are never held at once.
+      vector< vector<double> > stateProbabilities(numActions_total[state],
+						  vector<double> (numStates,0));
       for (int action = 0; action < numActions_total[state]; action++)
 	{
 	  payoffs[state][action] = game.payoffs(state,action);
 	  for (int statep = 0; statep < numStates; statep++)
 	    {
-		(probabilities[state][action][statep]
+		(stateProbabilities[action][statep]
 		 = game.probability(state,action,statep));
 	      assert (game.probability(state,action,statep)>=0);
 	    }
@@ -56,9 +62,13 @@ SGGame::SGGame(const SGAbstractGame & game):
 	  eqActions[state].push_back(game.isEquilibriumAction(state,action));
 	  
 	} // for action 
+      sparseProbabilities.setState(state,stateProbabilities);
     } // for state
   if(!transitionProbsSumToOne())
     throw(SGException(SG::PROB_SUM_NOT1));
+
+  updateSparseTransitions();
+  updateTransitionRows();
 } // Conversion from SGAbstractGame
 
 SGGame::SGGame(double _delta,
@@ -105,6 +115,7 @@ SGGame::SGGame(int _numPlayers,
   numActions(_numActions),
   probabilities(_probabilities),
   numActions_total(numStates,1),
+  sparseTransitions(false),
   eqActions(_eqActions),
   unconstrained(_unconstrained)
 {
@@ -162,8 +173,167 @@ SGGame::SGGame(int _numPlayers,
   if(unconstrained.size()!=numPlayers)
     throw(SGException(SG::OUT_OF_BOUNDS));
 
+  updateSparseTransitions();
+  updateTransitionRows();
 } // SGGame main constructor
 
+void SGGame::updateSparseTransitions()
+{
+  if (sparseTransitions)
+    {
+      if (sparseProbabilities.density() < maxSparseDensity)
+	return;
+      probabilities = sparseProbabilities.dense();
+      sparseProbabilities = SGSparseTransitions();
+      sparseTransitions = false;
+    }
+  else if (SGSparseTransitions::density(probabilities) < maxSparseDensity)
+    {
+      sparseProbabilities = SGSparseTransitions(probabilities);
+      probabilities.clear();
+      sparseTransitions = true;
+    }
+} // updateSparseTransitions
+
+void SGGame::updateTransitionRows()
+{
+  // Rows are compared by their nonzero entries, which works for
+  // either storage.
+  typedef pair< vector<int>,vector<double> > Row;
+  map< Row,int > rowIDs;
+  transitionRows.clear();
+  transitionRowCounts.clear();
+  transitionRowIDs.resize(numStates);
+  for (int state = 0; state < numStates; state++)
+    {
+      transitionRowIDs[state].resize(numActions_total[state]);
+      for (int action = 0; action < numActions_total[state]; action++)
+	{
+	  Row row;
+	  forEachTransition(state,action,[&row](int sp, double prob)
+			    {
+			      if (prob == 0)
+				return;
+			      row.first.push_back(sp);
+			      row.second.push_back(prob);
+			    });
+	  auto inserted = rowIDs.insert(pair< Row,int >
+					(row,transitionRows.size()));
+	  if (inserted.second)
+	    {
+	      transitionRows.push_back(pair<int,int>(state,action));
+	      transitionRowCounts.push_back(0);
+	    }
+	  transitionRowIDs[state][action] = inserted.first->second;
+	  transitionRowCounts[inserted.first->second]++;
+	}
+    }
+} // updateTransitionRows
+
+void SGGame::updateTransitionRow(int state, int action)
+{
+  const int row = transitionRowIDs[state][action];
+  if (transitionRowCounts[row] == 1)
+    return;
+
+  transitionRowCounts[row]--;
+  transitionRowIDs[state][action] = transitionRows.size();
+  transitionRows.push_back(pair<int,int>(state,action));
+  transitionRowCounts.push_back(1);
+
+  if (transitionRows[row] != pair<int,int>(state,action))
+    return;
+
+  // The profile was the first with the old ID, so the next one with
+  // that ID comes after it.
+  int nextState = state, nextAction = action+1;
+  while (true)
+    {
+      if (nextAction == transitionRowIDs[nextState].size())
+	{
+	  nextState++;
+	  nextAction = 0;
+	  continue;
+	}
+      if (transitionRowIDs[nextState][nextAction] == row)
+	break;
+      nextAction++;
+    }
+  transitionRows[row] = pair<int,int>(nextState,nextAction);
+} // updateTransitionRow
+
+int SGGame::deviationStep(int state, int player) const
+{
+  // Profiles are indexed by a=a_0+n_0*(a_1+n_1*(...)), so player i's
+  // action moves the index in steps of n_0*...*n_{i-1}.
+  int step = 1;
+  for (int p = 0; p < player; p++)
+    step *= numActions[state][p];
+  return step;
+} // deviationStep
+
+double SGGame::minICPayoff(int state, int action, int player,
+			   const SGTuple & threatTuple) const
+{
+  const int n = numActions[state][player];
+  const int step = deviationStep(state,player);
+  const int base = action - ((action/step)%n)*step;
+  const double u = payoffs[state][action][player];
+
+  double minIC = -numeric_limits<double>::max();
+  for (int d = 0, dev = base; d < n; d++, dev += step)
+    {
+      const double gain = (1-delta)/delta * (payoffs[state][dev][player] - u)
+	+ expectation(threatTuple,state,dev,player);
+      if (gain > minIC)
+	minIC = gain;
+    }
+  return minIC;
+} // minICPayoff
+
+void SGGame::minICPayoffs(int state, const SGTuple & threatTuple,
+			  vector<SGPoint> & minIC) const
+{
+  const int numProfiles = numActions_total[state];
+
+  // Expected threat payoffs after each profile. Profiles with the
+  // same transition row share them.
+  vector<double> threats(numProfiles*numPlayers);
+  unordered_map<int,int> rowProfiles;
+  for (int action = 0; action < numProfiles; action++)
+    {
+      auto inserted = rowProfiles.insert(pair<int,int>(transitionRowIDs[state][action],
+						       action));
+      for (int player = 0; player < numPlayers; player++)
+	threats[action*numPlayers+player]
+	  = (inserted.second
+	     ? expectation(threatTuple,state,action,player)
+	     : threats[inserted.first->second*numPlayers+player]);
+    }
+
+  const vector<SGPoint> & statePayoffs = payoffs[state];
+  minIC.assign(numProfiles,SGPoint(numPlayers,0.0));
+  for (int player = 0, step = 1; player < numPlayers; player++)
+    {
+      const int n = numActions[state][player];
+      for (int action = 0; action < numProfiles; action++)
+	{
+	  const int base = action - ((action/step)%n)*step;
+	  const double u = statePayoffs[action][player];
+	  double actionMinIC = -numeric_limits<double>::max();
+	  for (int d = 0, dev = base; d < n; d++, dev += step)
+	    {
+	      const double gain = (1-delta)/delta * (statePayoffs[dev][player] - u)
+		+ threats[dev*numPlayers+player];
+	      if (gain > actionMinIC)
+		actionMinIC = gain;
+	    }
+	  minIC[action][player] = actionMinIC;
+	}
+      step *= n;
+    }
+} // minICPayoffs
+
 void SGGame::getPayoffBounds(SGPoint & UB, SGPoint & LB) const
 {
   UB = SGPoint(numPlayers,numeric_limits<double>::min());
@@ -220,7 +390,11 @@ bool SGGame::setProbability(int state, int action,
       && action >= 0 && action < numActions_total[state]
       && prob >= 0)
     {
-      probabilities[state][action][newState] = prob;
+      if (sparseTransitions)
+	sparseProbabilities.set(state,action,newState,prob);
+      else
+	probabilities[state][action][newState] = prob;
+      updateTransitionRow(state,action);
       return true;
     }
   return false;
@@ -235,9 +409,16 @@ bool SGGame::addAction(int state, int player, int position)
   if (position < 0 || position > numActions[state][player])
     return false;
   
+  // Edit the state's transitions in dense form.
+  vector< vector<double> > stateProbabilities;
+  if (sparseTransitions)
+    stateProbabilities = sparseProbabilities.denseState(state);
+  else
+    stateProbabilities.swap(probabilities[state]);
+
   payoffs[state].reserve(payoffs[state].size()+numActions[state][1-player]);
-  probabilities[state].reserve(probabilities[state].size()
-			       +numActions[state][1-player]);
+  stateProbabilities.reserve(stateProbabilities.size()
+			     +numActions[state][1-player]);
 
   vector<double> newProbabilities(numStates,0);
   newProbabilities[state] = 1;
@@ -254,14 +435,14 @@ bool SGGame::addAction(int state, int player, int position)
   vector<SGPoint>::iterator point
     = payoffs[state].begin()+position*ownIncrement;
   vector< vector<double> >::iterator probvec
-    = probabilities[state].begin()+position*ownIncrement;
+    = stateProbabilities.begin()+position*ownIncrement;
   vector<bool>::iterator eqActionsvec
     = eqActions[state].begin()+position*ownIncrement;
   
   for (int aj = 0; aj < numActions[state][1-player]; aj++)
     {
       payoffs[state].insert(point,SGPoint(numPlayers,0.0));
-      probabilities[state].insert(probvec,newProbabilities);
+      stateProbabilities.insert(probvec,newProbabilities);
       if (!eqActions[state].empty())
 	eqActions[state].insert(eqActionsvec,true);
 
@@ -272,6 +453,11 @@ bool SGGame::addAction(int state, int player, int position)
 
   numActions[state][player] ++;
   numActions_total[state] = numActions[state][0] * numActions[state][1];
+  if (sparseTransitions)
+    sparseProbabilities.setState(state,stateProbabilities);
+  else
+    probabilities[state].swap(stateProbabilities);
+  updateTransitionRows();
 
   return true;
 } // addAction
@@ -294,13 +480,20 @@ bool SGGame::removeAction(int state, int player, int position)
       ownIncrement = numActions[state][1-player];
       otherIncrement = 1;
     }
+
+  // Edit the state's transitions in dense form.
+  vector< vector<double> > stateProbabilities;
+  if (sparseTransitions)
+    stateProbabilities = sparseProbabilities.denseState(state);
+  else
+    stateProbabilities.swap(probabilities[state]);
   
   // Start the iterator at the position of the last action
   vector<SGPoint>::iterator point
     = payoffs[state].end()-1
     - (numActions[state][player]-1-position)*ownIncrement;
   vector< vector<double> >::iterator probvec
-    = probabilities[state].end()-1
+    = stateProbabilities.end()-1
     - (numActions[state][player]-1-position)*ownIncrement;
   vector<bool>::iterator eqActionsvec
     = eqActions[state].end()-1
@@ -309,7 +502,7 @@ bool SGGame::removeAction(int state, int player, int position)
   for (int aj = 0; aj < numActions[state][1-player]; aj++)
     {
       payoffs[state].erase(point--);
-      probabilities[state].erase(probvec--);
+      stateProbabilities.erase(probvec--);
       if (!eqActions[state].empty())
 	eqActions[state].erase(eqActionsvec--);
 
@@ -320,6 +513,11 @@ bool SGGame::removeAction(int state, int player, int position)
   
   numActions[state][player] --;
   numActions_total[state] = numActions[state][0] * numActions[state][1];
+  if (sparseTransitions)
+    sparseProbabilities.setState(state,stateProbabilities);
+  else
+    probabilities[state].swap(stateProbabilities);
+  updateTransitionRows();
 
   return true;
 } // removeAction
@@ -336,20 +534,27 @@ bool SGGame::addState(int position)
   numActions_total.insert(numActions_total.begin()+position,1);
   payoffs.insert(payoffs.begin()+position,
 		 vector<SGPoint>(1,SGPoint(numPlayers,0.0)));
-  probabilities.insert(probabilities.begin()+position,
-		       vector< vector<double> > (1, vector<double>(numStates,0)));
-  probabilities[position].back()[position] = 1.0;
-
-  for (int state = 0; state < numStates; state++)
+  if (sparseTransitions)
+    sparseProbabilities.insertState(position);
+  else
     {
-      if (state == position)
-	continue;
+      probabilities.insert(probabilities.begin()+position,
+			   vector< vector<double> > (1, vector<double>(numStates,0)));
+      probabilities[position].back()[position] = 1.0;
+
+      for (int state = 0; state < numStates; state++)
+	{
+	  if (state == position)
+	    continue;
       
-      for (int action = 0; action < numActions_total[state]; action++)
-	probabilities[state][action]
-	  .insert(probabilities[state][action].begin()+position,0.0);
+	  for (int action = 0; action < numActions_total[state]; action++)
+	    probabilities[state][action]
+	      .insert(probabilities[state][action].begin()+position,0.0);
+	}
     }
 
+  updateSparseTransitions();
+  updateTransitionRows();
   return true;
 } // addState
 
@@ -366,14 +571,22 @@ bool SGGame::removeState(int state)
   numActions_total.erase(numActions_total.begin()+state);
   payoffs.erase(payoffs.begin()+state);
   eqActions.erase(eqActions.begin()+state);
-  probabilities.erase(probabilities.begin()+state);
-  
-  for (int state = 0; state < numStates; state++)
+  if (sparseTransitions)
+    sparseProbabilities.eraseState(state);
+  else
     {
-      for (int action = 0; action < numActions_total[state]; action++)
-	probabilities[state][action].erase(probabilities[state][action].begin()
+      probabilities.erase(probabilities.begin()+state);
+  
+      for (int s = 0; s < numStates; s++)
+	{
+	  for (int action = 0; action < numActions_total[s]; action++)
+	    probabilities[s][action].erase(probabilities[s][action].begin()
 					   +state);
+	}
     }
+
+  updateSparseTransitions();
+  updateTransitionRows();
   return true;
 } // removeState
 
@@ -389,15 +602,15 @@ bool SGGame::setConstrained(const vector<bool> & _unconstrained)
 
 bool SGGame::transitionProbsSumToOne(double tolerance) const
 {
-  for (int s = 0; s < probabilities.size(); s++)
+  for (int s = 0; s < numStates; s++)
     {
-      for (int a = 0; a < probabilities[s].size(); a++)
+      for (int a = 0; a < numActions_total[s]; a++)
 	{
 	  double probSum = 0.0;
-	  for (int sp = 0; sp < probabilities[s][a].size(); sp++)
-	    {
-	      probSum += probabilities[s][a][sp];
-	    }
+	  forEachTransition(s,a,[&probSum](int sp, double prob)
+			    {
+			      probSum += prob;
+			    });
 	  if (abs(probSum-1.0)>tolerance)
 	    return false;
 	}
@@ -438,7 +651,7 @@ bool SGGame::profitableDeviation(vector<int> & input, SGGame game)
 	  double cont_payoff = 0.0;
 	  for(st=0;st<game.numStates;st++)
           {	
-	    cont_payoff += guess[i][st] * game.probabilities[s][input_action][st];
+	    cont_payoff += guess[i][st] * game.getProbability(s,input_action,st);
 	  }
           valuefunction[i][s] = (1-game.delta)*(game.payoffs[s][input_action][i])+game.delta*cont_payoff;
 	  if(abs(valuefunction[i][s] - guess[i][s]) > error)
@@ -464,7 +677,7 @@ bool SGGame::profitableDeviation(vector<int> & input, SGGame game)
 	{
 	  for(st=0;st<game.numStates;st++)
 	  {
-	    cont_payoff += game.probabilities[s][j][st]*valuefunction[i][st];
+	    cont_payoff += game.getProbability(s,j,st)*valuefunction[i][st];
 	  }	  
 	  dev_payoff = game.payoffs[s][j][i]*(1-game.delta)+game.delta*cont_payoff;
 	  if(dev_payoff > valuefunction[i][s])
@@ -0,0 +1,209 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#include "sggeodesicmesh.hpp"
+
+SGGeodesicMesh::SGGeodesicMesh()
+{
+  // Vertices of the icosahedron are the cyclic permutations of
+  // (0,+-1,+-phi).
+  const double phi = (1.0+sqrt(5.0))/2.0;
+  const double coords[12][3] = {
+    {-1,phi,0}, {1,phi,0}, {-1,-phi,0}, {1,-phi,0},
+    {0,-1,phi}, {0,1,phi}, {0,-1,-phi}, {0,1,-phi},
+    {phi,0,-1}, {phi,0,1}, {-phi,0,-1}, {-phi,0,1}
+  };
+  // The icosahedron is mapped to itself by cyclic permutations of
+  // the coordinates, under which many games are symmetric. It is
+  // rotated about a generic axis, so that symmetric directions,
+  // where optimal policies are often tied, are not vertices.
+  const double axis[3] = {1.0/sqrt(14.0),2.0/sqrt(14.0),3.0/sqrt(14.0)};
+  const double angle = 0.5;
+  const double c = cos(angle), s = sin(angle);
+  for (int v = 0; v < 12; v++)
+    {
+      // Rodrigues' rotation formula
+      SGPoint vertex(3,0.0);
+      double dot = 0;
+      for (int i = 0; i < 3; i++)
+	dot += axis[i]*coords[v][i];
+      for (int i = 0; i < 3; i++)
+	{
+	  const double cross = (axis[(i+1)%3]*coords[v][(i+2)%3]
+				-axis[(i+2)%3]*coords[v][(i+1)%3]);
+	  vertex[i] = c*coords[v][i]+s*cross+(1-c)*dot*axis[i];
+	}
+      vertices.push_back(vertex/vertex.norm());
+    }
+  refCounts.resize(vertices.size(),0);
+
+  const int faces[20][3] = {
+    {0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+    {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+    {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+    {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}
+  };
+  vector<int> added;
+  for (int f = 0; f < 20; f++)
+    {
+      Triangle face;
+      for (int k = 0; k < 3; k++)
+	face.corners[k] = faces[f][k];
+      face.children = -1;
+      face.leaf = true;
+      face.coarsened = false;
+      face.fixed = false;
+      face.depth = 0;
+      triangles.push_back(face);
+      addLeaf(f,added);
+    }
+} // constructor
+
+int SGGeodesicMesh::midpoint(int v0, int v1)
+{
+  const std::pair<int,int> edge(std::min(v0,v1),std::max(v0,v1));
+  auto it = midpoints.find(edge);
+  if (it != midpoints.end())
+    return it->second;
+
+  SGPoint vertex = vertices[edge.first]+vertices[edge.second];
+  vertices.push_back(vertex/vertex.norm());
+  refCounts.push_back(0);
+  midpoints[edge] = vertices.size()-1;
+  return vertices.size()-1;
+} // midpoint
+
+void SGGeodesicMesh::addLeaf(int t, vector<int> & added)
+{
+  triangles[t].leaf = true;
+  for (int k = 0; k < 3; k++)
+    {
+      const int v = triangles[t].corners[k];
+      if (refCounts[v]++ == 0)
+	added.push_back(v);
+    }
+} // addLeaf
+
+void SGGeodesicMesh::removeLeaf(int t, vector<int> & removed)
+{
+  triangles[t].leaf = false;
+  for (int k = 0; k < 3; k++)
+    {
+      const int v = triangles[t].corners[k];
+      if (--refCounts[v] == 0)
+	removed.push_back(v);
+    }
+} // removeLeaf
+
+bool SGGeodesicMesh::isCoarsenable(int t) const
+{
+  const Triangle & tri = triangles[t];
+  if (tri.leaf || tri.fixed)
+    return false;
+  for (int c = 0; c < 4; c++)
+    {
+      if (!triangles[tri.children+c].leaf)
+	return false;
+    }
+  return true;
+} // isCoarsenable
+
+int SGGeodesicMesh::edgeMidpoint(int t, int k) const
+{
+  assert(triangles[t].children >= 0);
+  return triangles[triangles[t].children+3].corners[k];
+} // edgeMidpoint
+
+vector<int> SGGeodesicMesh::leaves() const
+{
+  vector<int> result;
+  for (int t = 0; t < triangles.size(); t++)
+    {
+      if (triangles[t].leaf)
+	result.push_back(t);
+    }
+  return result;
+} // leaves
+
+void SGGeodesicMesh::refine(int t, vector<int> & added)
+{
+  assert(triangles[t].leaf);
+
+  if (triangles[t].children < 0)
+    {
+      // Create the children. The corners of the central child are
+      // the midpoints of edges 0, 1, and 2.
+      const int a = triangles[t].corners[0];
+      const int b = triangles[t].corners[1];
+      const int c = triangles[t].corners[2];
+      const int ab = midpoint(a,b);
+      const int bc = midpoint(b,c);
+      const int ca = midpoint(c,a);
+      const int childCorners[4][3] = {
+	{a,ab,ca}, {ab,b,bc}, {ca,bc,c}, {ab,bc,ca}
+      };
+
+      triangles[t].children = triangles.size();
+      for (int child = 0; child < 4; child++)
+	{
+	  Triangle tri;
+	  for (int k = 0; k < 3; k++)
+	    tri.corners[k] = childCorners[child][k];
+	  tri.children = -1;
+	  tri.leaf = false;
+	  tri.coarsened = false;
+	  tri.fixed = false;
+	  tri.depth = triangles[t].depth+1;
+	  triangles.push_back(tri);
+	}
+    }
+
+  // Add the children before removing t, so that its corners stay
+  // active.
+  for (int child = 0; child < 4; child++)
+    addLeaf(triangles[t].children+child,added);
+  vector<int> removed;
+  removeLeaf(t,removed);
+  assert(removed.empty());
+} // refine
+
+void SGGeodesicMesh::coarsen(int t, vector<int> & removed)
+{
+  assert(isCoarsenable(t));
+
+  vector<int> added;
+  addLeaf(t,added);
+  assert(added.empty());
+  for (int child = 0; child < 4; child++)
+    removeLeaf(triangles[t].children+child,removed);
+  triangles[t].coarsened = true;
+} // coarsen
+
+void SGGeodesicMesh::refineAll(vector<int> & added)
+{
+  const vector<int> leafTriangles = leaves();
+  for (int t : leafTriangles)
+    {
+      refine(t,added);
+      triangles[t].fixed = true;
+    }
+} // refineAll
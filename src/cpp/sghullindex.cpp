@@ -0,0 +1,230 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#include "sghullindex.hpp"
+#include <map>
+
+//! True if a is lexicographically above b in dir, then dir rotated clockwise.
+static bool lexGreater(const SGPoint & a, const SGPoint & b, const SGPoint & dir)
+{
+  const double diff = a*dir-b*dir;
+  if (diff != 0)
+    return diff > 0;
+  const SGPoint dir2(dir[1],-dir[0]);
+  return a*dir2 > b*dir2;
+} // lexGreater
+
+SGHullIndex::SGHullIndex(const SGGame & game, int state,
+			 const vector<SGAction_MaxMinMax> & actions,
+			 double _tolerance):
+  tolerance(_tolerance)
+{
+  map<int,int> groupIndex;
+  vector< vector<SGPoint> > stagePayoffs;
+  for (SGActionID id = 0; id < actions.size(); id++)
+    {
+      const int gameAction = actions[id].getAction();
+      auto inserted = groupIndex.insert(pair<int,int>
+					(game.getTransitionRowID(state,gameAction),
+					 groups.size()));
+      if (inserted.second)
+	{
+	  groups.push_back(Group());
+	  stagePayoffs.push_back(vector<SGPoint>());
+	}
+      groups[inserted.first->second].actions.push_back(id);
+      stagePayoffs[inserted.first->second]
+	.push_back(game.getPayoffs()[state][gameAction]);
+    }
+
+  for (int g = 0; g < groups.size(); g++)
+    buildHull(groups[g],stagePayoffs[g]);
+} // constructor
+
+void SGHullIndex::buildHull(Group & group,
+			    const vector<SGPoint> & stagePayoffs)
+{
+  // Sort the actions by stage payoff and merge equal payoffs.
+  vector<int> order(stagePayoffs.size());
+  for (int i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::stable_sort(order.begin(),order.end(),[&](int i, int j)
+		   {
+		     return (stagePayoffs[i][0] < stagePayoffs[j][0]
+			     || (stagePayoffs[i][0] == stagePayoffs[j][0]
+				 && stagePayoffs[i][1] < stagePayoffs[j][1]));
+		   });
+  vector<SGPoint> points;
+  vector< vector<SGActionID> > pointActions;
+  for (int k = 0; k < order.size(); k++)
+    {
+      const SGPoint & p = stagePayoffs[order[k]];
+      if (points.empty() || points.back() != p)
+	{
+	  points.push_back(p);
+	  pointActions.push_back(vector<SGActionID>());
+	}
+      pointActions.back().push_back(group.actions[order[k]]);
+    }
+
+  // Andrew's monotone chain. Collinear points are dropped, since they
+  // are never strictly best in any direction.
+  const int n = points.size();
+  vector<int> hull;
+  if (n <= 2)
+    {
+      for (int i = 0; i < n; i++)
+	hull.push_back(i);
+    }
+  else
+    {
+      vector<int> chain(2*n);
+      int k = 0;
+      auto cross = [&](int o, int a, int b)
+	{
+	  return ((points[a][0]-points[o][0])*(points[b][1]-points[o][1])
+		  - (points[a][1]-points[o][1])*(points[b][0]-points[o][0]));
+	};
+      for (int i = 0; i < n; i++)
+	{
+	  while (k >= 2 && cross(chain[k-2],chain[k-1],i) <= 0)
+	    k--;
+	  chain[k++] = i;
+	}
+      for (int i = n-2, lower = k+1; i >= 0; i--)
+	{
+	  while (k >= lower && cross(chain[k-2],chain[k-1],i) <= 0)
+	    k--;
+	  chain[k++] = i;
+	}
+      hull.assign(chain.begin(),chain.begin()+k-1);
+    }
+
+  for (int i = 0; i < hull.size(); i++)
+    {
+      group.vertices.push_back(points[hull[i]]);
+      group.vertexActions.push_back(pointActions[hull[i]]);
+      std::sort(group.vertexActions.back().begin(),
+		group.vertexActions.back().end());
+    }
+
+  // Points that are not vertices but are within the tolerance of
+  // the boundary. The distance to the boundary is the smallest
+  // distance to the line through an edge.
+  vector<bool> isVertex(n,false);
+  for (int i = 0; i < hull.size(); i++)
+    isVertex[hull[i]] = true;
+  for (int i = 0; i < n; i++)
+    {
+      if (isVertex[i])
+	continue;
+      double depth = numeric_limits<double>::max();
+      for (int k = 0; k < hull.size() && hull.size() >= 2; k++)
+	{
+	  SGPoint edge = points[hull[(k+1)%hull.size()]]-points[hull[k]];
+	  const double length = edge.norm();
+	  if (length == 0)
+	    continue;
+	  depth = std::min(depth,abs(edge.getNormal()*(points[i]-points[hull[k]]))/length);
+	}
+      if (depth <= tolerance)
+	{
+	  for (SGActionID id : pointActions[i])
+	    {
+	      group.boundaryActions.push_back(id);
+	      group.boundaryPayoffs.push_back(points[i]);
+	    }
+	}
+    }
+
+  // Outward normals of the edges, sorted by angle
+  if (hull.size() >= 2)
+    {
+      vector< pair<double,int> > normals(hull.size());
+      for (int i = 0; i < hull.size(); i++)
+	{
+	  const SGPoint & a = group.vertices[i];
+	  const SGPoint & b = group.vertices[(i+1)%hull.size()];
+	  normals[i] = pair<double,int>(atan2(-(b[0]-a[0]),b[1]-a[1]),i);
+	}
+      std::sort(normals.begin(),normals.end());
+      for (int i = 0; i < normals.size(); i++)
+	{
+	  group.normalAngles.push_back(normals[i].first);
+	  group.normalVertices.push_back(normals[i].second);
+	}
+    }
+} // buildHull
+
+void SGHullIndex::bestActions(int g, const SGPoint & dir,
+			      vector<SGActionID> & best,
+			      vector<SGActionID> & nearBest) const
+{
+  const Group & group = groups[g];
+  const int n = group.vertices.size();
+  best.clear();
+  nearBest.clear();
+
+  int top = 0;
+  if (n > 1)
+    {
+      // The best vertex starts the first edge whose normal is at or
+      // counter-clockwise from dir.
+      const double theta = atan2(dir[1],dir[0]);
+      const int pos = std::lower_bound(group.normalAngles.begin(),
+				       group.normalAngles.end(),theta)
+	- group.normalAngles.begin();
+      top = group.normalVertices[pos % group.normalVertices.size()];
+
+      // Guard against round-off in the angles by moving to a better
+      // neighbour, which terminates since the hull is convex.
+      while (true)
+	{
+	  const int next = (top+1)%n, prev = (top+n-1)%n;
+	  if (lexGreater(group.vertices[next],group.vertices[top],dir))
+	    top = next;
+	  else if (lexGreater(group.vertices[prev],group.vertices[top],dir))
+	    top = prev;
+	  else
+	    break;
+	}
+    }
+  best = group.vertexActions[top];
+
+  // Vertices within the tolerance of the best level are contiguous.
+  const double minLevel = group.vertices[top]*dir-tolerance;
+  int k;
+  for (k = 1; k < n && group.vertices[(top+k)%n]*dir >= minLevel; k++)
+    nearBest.insert(nearBest.end(),
+		    group.vertexActions[(top+k)%n].begin(),
+		    group.vertexActions[(top+k)%n].end());
+  for (int j = 1; j < n-k+1 && group.vertices[(top+n-j)%n]*dir >= minLevel; j++)
+    nearBest.insert(nearBest.end(),
+		    group.vertexActions[(top+n-j)%n].begin(),
+		    group.vertexActions[(top+n-j)%n].end());
+
+  for (int i = 0; i < group.boundaryActions.size(); i++)
+    {
+      if (group.boundaryPayoffs[i]*dir >= minLevel)
+	nearBest.push_back(group.boundaryActions[i]);
+    }
+} // bestActions
@@ -0,0 +1,337 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#include "sglevelmatrix.hpp"
+
+#if defined(__GNUC__)
+typedef double SGVec4 __attribute__((vector_size(32)));
+#endif
+
+//! y += a*x for n a multiple of 4 and 32-byte aligned x and y.
+static inline void sgaxpy(double a, const double * x, double * y, int n)
+{
+#if defined(__GNUC__)
+  const SGVec4 av = {a,a,a,a};
+  for (int i = 0; i < n; i += 4)
+    {
+      SGVec4 xv = *reinterpret_cast<const SGVec4 *>(x+i);
+      SGVec4 & yv = *reinterpret_cast<SGVec4 *>(y+i);
+      yv += av*xv;
+    }
+#else
+  for (int i = 0; i < n; i++)
+    y[i] += a*x[i];
+#endif
+} // sgaxpy
+
+void SGLevelMatrix::reserveColumns(int minColumns)
+{
+  if (minColumns <= stride)
+    return;
+
+  int newStride = std::max(2*stride,width);
+  while (newStride < minColumns)
+    newStride *= 2;
+
+  AlignedVector newDirections(numPlayers*newStride,0.0);
+  AlignedVector newLevels(numStates*newStride,0.0);
+  for (int p = 0; p < numPlayers; p++)
+    std::copy(directions.begin()+p*stride,
+	      directions.begin()+p*stride+numDirections,
+	      newDirections.begin()+p*newStride);
+  for (int s = 0; s < numStates; s++)
+    std::copy(levels.begin()+s*stride,
+	      levels.begin()+s*stride+numDirections,
+	      newLevels.begin()+s*newStride);
+
+  directions.swap(newDirections);
+  levels.swap(newLevels);
+  stride = newStride;
+} // reserveColumns
+
+SGPoint SGLevelMatrix::getDirection(int d) const
+{
+  if (d < 0 || d >= numDirections)
+    throw(SGException(SG::OUT_OF_BOUNDS));
+
+  SGPoint dir(numPlayers);
+  for (int p = 0; p < numPlayers; p++)
+    dir[p] = directions[p*stride+d];
+  return dir;
+} // getDirection
+
+vector<double> SGLevelMatrix::getLevels(int d) const
+{
+  if (d < 0 || d >= numDirections)
+    throw(SGException(SG::OUT_OF_BOUNDS));
+
+  vector<double> dirLevels(numStates);
+  for (int s = 0; s < numStates; s++)
+    dirLevels[s] = levels[s*stride+d];
+  return dirLevels;
+} // getLevels
+
+void SGLevelMatrix::push_back(const SGPoint & dir,
+			      const vector<double> & dirLevels)
+{
+  if (dir.size() != numPlayers
+      || dirLevels.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  reserveColumns(numDirections+1);
+  for (int p = 0; p < numPlayers; p++)
+    directions[p*stride+numDirections] = dir[p];
+  for (int s = 0; s < numStates; s++)
+    levels[s*stride+numDirections] = dirLevels[s];
+  numDirections++;
+} // push_back
+
+void SGLevelMatrix::push_front(const SGPoint & dir,
+			       const vector<double> & dirLevels)
+{
+  if (dir.size() != numPlayers
+      || dirLevels.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  reserveColumns(numDirections+1);
+  for (int p = 0; p < numPlayers; p++)
+    {
+      double * row = &directions[p*stride];
+      std::copy_backward(row,row+numDirections,row+numDirections+1);
+      row[0] = dir[p];
+    }
+  for (int s = 0; s < numStates; s++)
+    {
+      double * row = &levels[s*stride];
+      std::copy_backward(row,row+numDirections,row+numDirections+1);
+      row[0] = dirLevels[s];
+    }
+  numDirections++;
+} // push_front
+
+void SGLevelMatrix::erase(const vector<bool> & remove)
+{
+  if (remove.size() != numDirections)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  int newNumDirections = 0;
+  for (int d = 0; d < numDirections; d++)
+    {
+      if (remove[d])
+	continue;
+      for (int p = 0; p < numPlayers; p++)
+	directions[p*stride+newNumDirections] = directions[p*stride+d];
+      for (int s = 0; s < numStates; s++)
+	levels[s*stride+newNumDirections] = levels[s*stride+d];
+      newNumDirections++;
+    }
+
+  // Keep the padding at zero
+  for (int p = 0; p < numPlayers; p++)
+    std::fill(directions.begin()+p*stride+newNumDirections,
+	      directions.begin()+p*stride+numDirections,0.0);
+  for (int s = 0; s < numStates; s++)
+    std::fill(levels.begin()+s*stride+newNumDirections,
+	      levels.begin()+s*stride+numDirections,0.0);
+  numDirections = newNumDirections;
+} // erase
+
+void SGLevelMatrix::clear()
+{
+  std::fill(directions.begin(),directions.end(),0.0);
+  std::fill(levels.begin(),levels.end(),0.0);
+  numDirections = 0;
+} // clear
+
+int SGLevelMatrix::blockSize() const
+{
+  // Process the directions in blocks so that the block of the level
+  // matrix, one column per direction and one row per state, stays
+  // in L1 cache while it is multiplied by all of the transition
+  // rows.
+  const int blockBytes = 16384;
+  return std::max(width,
+		  (blockBytes/static_cast<int>(sizeof(double)
+					       *std::max(numStates,1)))
+		  /width*width);
+} // blockSize
+
+void SGLevelMatrix::expectedLevels(const vector<const vector<double> *> & probs,
+				   double * out) const
+{
+  const int numRows = probs.size();
+  const int numColumns = ((numDirections+width-1)/width)*width;
+  const int block = blockSize();
+
+  for (int d0 = 0; d0 < numColumns; d0 += block)
+    {
+      const int d1 = std::min(numColumns,d0+block);
+      for (int r = 0; r < numRows; r++)
+	{
+	  const vector<double> & prob = *probs[r];
+	  double * outRow = out+r*stride;
+	  std::fill(outRow+d0,outRow+d1,0.0);
+	  for (int sp = 0; sp < numStates; sp++)
+	    {
+	      // Adding zero does not change the sum
+	      if (prob[sp] == 0)
+		continue;
+	      sgaxpy(prob[sp],&levels[sp*stride+d0],outRow+d0,d1-d0);
+	    }
+	} // for r
+    } // for d0
+} // expectedLevels
+
+void SGLevelMatrix::expectedLevels(const vector<SGTransitionRow> & rows,
+				   double * out) const
+{
+  const int numRows = rows.size();
+  const int numColumns = ((numDirections+width-1)/width)*width;
+  const int block = blockSize();
+
+  for (int d0 = 0; d0 < numColumns; d0 += block)
+    {
+      const int d1 = std::min(numColumns,d0+block);
+      for (int r = 0; r < numRows; r++)
+	{
+	  const SGTransitionRow & row = rows[r];
+	  double * outRow = out+r*stride;
+	  std::fill(outRow+d0,outRow+d1,0.0);
+	  for (int k = 0; k < row.nnz; k++)
+	    sgaxpy(row.probs[k],&levels[row.states[k]*stride+d0],
+		   outRow+d0,d1-d0);
+	} // for r
+    } // for d0
+} // expectedLevels
+
+double SGLevelMatrix::distance(const SGLevelMatrix & levels0, int d0,
+			       const SGLevelMatrix & levels1, int d1)
+{
+  double dist = 0;
+  for (int state = 0; state < levels0.numStates; state++)
+    dist = std::max(dist,abs(levels0.level(d0,state)-levels1.level(d1,state)));
+
+  double dirDist = 0;
+  for (int p = 0; p < levels0.numPlayers; p++)
+    dirDist = std::max(dirDist,abs(levels0.direction(d0,p)-levels1.direction(d1,p)));
+
+  return dirDist+dist;
+} // distance
+
+double SGLevelMatrix::pseudoHausdorff_bruteForce(const SGLevelMatrix & newLevels,
+						 const SGLevelMatrix & oldLevels)
+{
+  if (newLevels.numPlayers != oldLevels.numPlayers
+      || newLevels.numStates != oldLevels.numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  double errorLevel = 0;
+  for (int d1 = 0; d1 < newLevels.size(); d1++)
+    {
+      double minDist = numeric_limits<double>::max();
+      for (int d0 = 0; d0 < oldLevels.size(); d0++)
+	minDist = std::min(minDist,distance(oldLevels,d0,newLevels,d1));
+      errorLevel = std::max(errorLevel,minDist);
+    }
+  return errorLevel;
+} // pseudoHausdorff_bruteForce
+
+double SGLevelMatrix::pseudoHausdorff(const SGLevelMatrix & newLevels,
+				      const SGLevelMatrix & oldLevels)
+{
+  if (newLevels.numPlayers != oldLevels.numPlayers
+      || newLevels.numStates != oldLevels.numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  if (newLevels.numPlayers != 2
+      || newLevels.empty()
+      || oldLevels.empty())
+    return pseudoHausdorff_bruteForce(newLevels,oldLevels);
+
+  // The bound on the distance between directions requires unit
+  // vectors.
+  for (int k = 0; k < 2; k++)
+    {
+      const SGLevelMatrix & lm = (k==0? newLevels : oldLevels);
+      for (int d = 0; d < lm.size(); d++)
+	{
+	  if (abs(lm.direction(d,0)*lm.direction(d,0)
+		  + lm.direction(d,1)*lm.direction(d,1) - 1.0) > 1e-9)
+	    return pseudoHausdorff_bruteForce(newLevels,oldLevels);
+	}
+    }
+
+  const int numOld = oldLevels.size();
+  vector< pair<double,int> > angles(numOld);
+  for (int d = 0; d < numOld; d++)
+    angles[d] = pair<double,int>(atan2(oldLevels.direction(d,1),
+				       oldLevels.direction(d,0)),d);
+  std::sort(angles.begin(),angles.end());
+
+  // Lower bound on the distance between two unit vectors separated
+  // by the angle sep, with a margin for round-off.
+  auto lowerBound = [](double sep)
+    {
+      return sqrt(2.0)*sin(0.5*sep)*(1.0-1e-9)-1e-12;
+    };
+
+  double errorLevel = 0;
+  for (int d1 = 0; d1 < newLevels.size(); d1++)
+    {
+      const double theta = atan2(newLevels.direction(d1,1),
+				 newLevels.direction(d1,0));
+      const int pos = std::lower_bound(angles.begin(),angles.end(),
+				       pair<double,int>(theta,-1))
+	- angles.begin();
+
+      double minDist = numeric_limits<double>::max();
+
+      // Counterclockwise from theta
+      for (int k = 0; k < numOld; k++)
+	{
+	  int idx = pos+k;
+	  double sep = angles[idx%numOld].first - theta;
+	  if (idx >= numOld)
+	    sep += 2.0*PI;
+	  if (sep > PI || lowerBound(sep) > minDist)
+	    break;
+	  minDist = std::min(minDist,distance(oldLevels,angles[idx%numOld].second,
+					      newLevels,d1));
+	}
+
+      // Clockwise from theta
+      for (int k = 0; k < numOld; k++)
+	{
+	  int idx = pos-1-k;
+	  double sep = theta - angles[(idx+numOld)%numOld].first;
+	  if (idx < 0)
+	    sep += 2.0*PI;
+	  if (sep > PI || lowerBound(sep) > minDist)
+	    break;
+	  minDist = std::min(minDist,distance(oldLevels,angles[(idx+numOld)%numOld].second,
+					      newLevels,d1));
+	}
+
+      errorLevel = std::max(errorLevel,minDist);
+    } // for d1
+
+  return errorLevel;
+} // pseudoHausdorff
@@ -21,12 +21,18 @@
 
 #include "sgpoint.hpp"
 #include "sgexception.hpp"
+#include <type_traits>
 
 /* SGPoint */
 
+// vector<SGPoint> only moves its elements on reallocation if the move
+// constructor cannot throw.
+static_assert(std::is_nothrow_move_constructible<SGPoint>::value,
+	      "SGPoint must be nothrow move constructible");
+
 bool SGPoint::anyNaN() const
 {
-  for (int p = 0; p < x.size(); p++)
+  for (int p = 0; p < n; p++)
     {
       if (isnan(x[p]))
 	return true;
@@ -36,13 +42,13 @@ bool SGPoint::anyNaN() const
 
 SGPoint SGPoint::getNormal() const
 {
-  assert(x.size()==2);
+  assert(n==2);
   return SGPoint(-x[1],x[0]);
 }
 
 double SGPoint::angle(const SGPoint& base) const
 {
-  assert(x.size()==2);
+  assert(n==2);
   const double colinearTol = 1e-13;
 
   if ( abs( (*this)*base.getNormal() ) <  colinearTol )
@@ -72,7 +78,7 @@ double SGPoint::angle(const SGPoint& base) const
 
 bool SGPoint::rotateCCW(double pi)
 {
-  assert(x.size()==2);
+  assert(n==2);
   double tmp = cos(pi)*x[0]-sin(pi)*x[1];
   x[1] = sin(pi)*x[0]+cos(pi)*x[1];
   x[0] = tmp;
@@ -82,12 +88,12 @@ bool SGPoint::rotateCCW(double pi)
 bool SGPoint::normalize()
 {
   double sum = 0;
-  for ( int k = 0; k < x.size(); k++)
+  for ( int k = 0; k < n; k++)
     sum += x[k]*x[k];
   double tmp = sqrt(sum);
   if (tmp < 1e-15)
     return false;
-  for ( int k = 0; k < x.size(); k++)
+  for ( int k = 0; k < n; k++)
     x[k] /= tmp;
 
   return true;
@@ -118,30 +124,30 @@ SGPoint SGPoint::cross(const SGPoint& p0,
 
 void SGPoint::max(const SGPoint & p)
 {
-  assert(x.size() == p.size());
-  for (int k = 0; k < x.size(); k++)
+  assert(n == p.size());
+  for (int k = 0; k < n; k++)
     x[k] = std::max(x[k],p[k]);
 }
 
 void SGPoint::min(const SGPoint & p)
 {
-  assert(x.size() == p.size());
-  for (int k = 0; k < x.size(); k++)
+  assert(n == p.size());
+  for (int k = 0; k < n; k++)
     x[k] = std::min(x[k],p[k]);
 }
 
 void SGPoint::plusWithWeight(const SGPoint & p,double w)
 {
-  assert(p.size() == x.size());
-  for (int k = 0; k < x.size(); k++)
+  assert(p.size() == n);
+  for (int k = 0; k < n; k++)
     x[k] += w*p[k];
 }
 
 // Made these operators inlined and included in header
 // double& SGPoint::operator[](int player)
 // {
-//   // player = player % x.size(); // Wrap around
-//   if(player < 0 || player >= x.size())
+//   // player = player % n; // Wrap around
+//   if(player < 0 || player >= n)
 //     throw(SGException(SG::OUT_OF_BOUNDS));
 
 //   return x[player];
@@ -149,56 +155,46 @@ void SGPoint::plusWithWeight(const SGPoint & p,double w)
 
 // const double& SGPoint::operator[](int player) const
 // {
-//   // player = player % x.size(); // Wrap around
-//   if(player < 0 || player >= x.size())
+//   // player = player % n; // Wrap around
+//   if(player < 0 || player >= n)
 //     throw(SGException(SG::OUT_OF_BOUNDS));
 
 //   return x[player];
 // }
 
-SGPoint& SGPoint::operator=(const SGPoint & rhs)
-{
-  // assert(this->x.size() == rhs.x.size());
-  if (this != &rhs)
-    {
-      this->x = rhs.x;
-    }
-  return *this;
-}
-
 SGPoint& SGPoint::operator=(double d)
 {
-  for (int k = 0; k < x.size(); k++)
+  for (int k = 0; k < n; k++)
     this->x[k] = d;
   return *this;
 }
 
 SGPoint& SGPoint::operator+=(const SGPoint & rhs)
 {
-  assert(this->x.size() == rhs.x.size());
-  for (int k=0; k<x.size(); k++)
+  assert(this->n == rhs.n);
+  for (int k=0; k<n; k++)
     this->x[k] += rhs.x[k];
   return *this;
 }
 
 SGPoint& SGPoint::operator-=(const SGPoint & rhs)
 {
-  assert(this->x.size() == rhs.x.size());
-  for (int k=0; k<x.size(); k++)
+  assert(this->n == rhs.n);
+  for (int k=0; k<n; k++)
     this->x[k] -= rhs.x[k];
   return *this;
 }
 
 SGPoint& SGPoint::operator-=(double d)
 {
-  for (int k=0; k<x.size(); k++)
+  for (int k=0; k<n; k++)
     this->x[k] -= d;
   return *this;
 }
 
 SGPoint& SGPoint::operator*=(double d)
 {
-  for (int k=0; k<x.size(); k++)
+  for (int k=0; k<n; k++)
     this->x[k] *= d;
   return *this;
 }
@@ -208,7 +204,7 @@ SGPoint& SGPoint::operator/=(double d)
   if(d==0.0)
     throw(SGException(SG::DIVIDE_BY_ZERO));
 
-  for (int k=0; k<x.size(); k++)
+  for (int k=0; k<n; k++)
     this->x[k] /= d;
   return *this;
 }
@@ -233,17 +229,9 @@ SGPoint operator*(const SGPoint & point,double d)
 SGPoint operator/(const SGPoint & point,double d)
 { return (SGPoint(point) /= d); } 
 
-double SGPoint::operator*(const SGPoint & rhs) const
-{
-  double sum = 0;
-  for (int k = 0; k < x.size(); k++)
-    sum += this->x[k]*rhs.x[k];
-  return sum;
-}
-
 bool SGPoint::operator==(const SGPoint & rhs) const
 {
-  for (int k = 0; k < this->x.size(); k++)
+  for (int k = 0; k < this->n; k++)
     {
       if (abs(this->x[k]-rhs.x[k]) > 0.0)
 	return false;
@@ -256,9 +244,9 @@ bool SGPoint::operator!=(const SGPoint & rhs) const
 
 bool SGPoint::operator>=(const SGPoint & rhs) const
 {
-  assert(x.size() == rhs.size());
+  assert(n == rhs.size());
   bool tf = true;
-  for (int k = 0; k < x.size(); k++)
+  for (int k = 0; k < n; k++)
     tf = tf && (this->x[k]>=rhs.x[k]);
   return tf; 
 }
@@ -266,9 +254,9 @@ bool SGPoint::operator>(const SGPoint & rhs) const
 { return !((*this)<=rhs); }
 bool SGPoint::operator<=(const SGPoint & rhs) const
 {
-  assert(x.size() == rhs.size());
+  assert(n == rhs.size());
   bool tf = true;
-  for (int k = 0; k < x.size(); k++)
+  for (int k = 0; k < n; k++)
     tf = tf && (this->x[k]<=rhs.x[k]);
   return tf; 
 }
@@ -277,7 +265,7 @@ bool SGPoint::operator<(const SGPoint & rhs) const
 bool SGPoint::operator>=(double rhs) const
 {
   bool tf = true;
-  for (int k = 0; k < x.size(); k++)
+  for (int k = 0; k < n; k++)
     tf = tf && (this->x[k]>=rhs);
   return tf; 
 }
@@ -286,7 +274,7 @@ bool SGPoint::operator>(double rhs) const
 bool SGPoint::operator<=(double rhs) const
 {
   bool tf = true;
-  for (int k = 0; k < x.size(); k++)
+  for (int k = 0; k < n; k++)
     tf = tf && (this->x[k]<=rhs);
   return tf; 
 }
@@ -295,14 +283,14 @@ bool SGPoint::operator<(double rhs) const
 
 ostream& operator<<(ostream& out, const SGPoint& rhs)
 {
-  if (rhs.x.size() > 0)
+  if (rhs.n > 0)
     {
       out.setf(std::ios::fixed,std::ios::floatfield);
       out.precision(3);
       out << "(";
       for (int k = 0; k < rhs.size()-1; k++)
 	out << std::setw(6) << rhs.x[k] << ", ";
-      out << std::setw(6) << rhs.x.back() << ")";
+      out << std::setw(6) << rhs.x[rhs.n-1] << ")";
       out.width(2);
     }
   else
@@ -341,7 +329,7 @@ void SGPoint::roundPoint(double tol)
 {
   if (tol>0)
     {
-      for (int k = 0; k < x.size(); k++)
+      for (int k = 0; k < n; k++)
 	x[k] = round(x[k]/tol)*tol;
     }
 }
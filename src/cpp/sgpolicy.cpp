@@ -22,63 +22,27 @@
 #include "sgpolicy.hpp"
 
 
-std::string SGPolicy::hash() const
+void SGPolicy::pack()
 {
-  std::string str;
+  const int regimeCode = (regime==SG::NonBinding? 0 : bindingPlayer+1);
+  const int pointCode = (regime==SG::NonBinding? 0 : bindingPoint);
 
-  str += "s";
-  str += std::to_string(action->getState());
-  str += "a";
-  str += std::to_string(action->getAction());
-  if (regime==SG::NonBinding)
-    str += "NB";
-  else
-    {
-      str += "Bp";
-      str += std::to_string(bindingPlayer);
-      str += "k";
-      str += std::to_string(bindingPoint);
-    }
-    
-  return str;
-}
+  key.hi = ((static_cast<uint64_t>(static_cast<uint32_t>(state)) << 32)
+	    | static_cast<uint32_t>(gameAction));
+  key.lo = ((static_cast<uint64_t>(static_cast<uint32_t>(regimeCode)) << 32)
+	    | static_cast<uint32_t>(pointCode));
+} // pack
 
 bool operator< (const SGPolicy & p1, const SGPolicy & p2)
 {
-  if (p1.action->getState() < p2.action->getState())
-    return true;
-  if (p1.action->getState() > p2.action->getState())
-    return false;
-
-  // States must be equal
-
-  if (p1.action->getAction() < p2.action->getAction())
-    return true;
-  if (p1.action->getAction() > p2.action->getAction())
-    return false;
-
-  // States and actions are equal
-
-  if (p1.regime == SG::NonBinding && p2.regime != SG::NonBinding)
-    return true;
-
-  if (p1.bindingPlayer < p2.bindingPlayer)
-    return true;
-  if (p1.bindingPlayer > p2.bindingPlayer)
-    return false;
-
-  // States, actions, regime, and binding player are equal
-  if (p1.bindingPoint < p2.bindingPoint)
-    return true;
-
-  return false;
+  return p1.key < p2.key;
 }
 
 ostream& operator<<(ostream& out, const SGPolicy& rhs)
 {
   out.setf(std::ios::fixed,std::ios::floatfield);
-  out << "s" << rhs.getAction()->getState()
-      << "a" << rhs.getAction()->getAction()
+  out << "s" << rhs.getState()
+      << "a" << rhs.getGameAction()
       << "r";
   if (rhs.getRegime()==SG::NonBinding)
     out << "N";
@@ -91,3 +55,12 @@ ostream& operator<<(ostream& out, const SGPolicy& rhs)
   return out;
 }
 
+ostream& operator<<(ostream& out, const SGPolicyHash& rhs)
+{
+  std::ios::fmtflags flags = out.flags();
+  out << std::hex << std::setfill('0')
+      << std::setw(16) << rhs.hi << std::setw(16) << rhs.lo;
+  out.flags(flags);
+  out << std::setfill(' ');
+  return out;
+}
@@ -0,0 +1,293 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#include "sgpolicyevaluator.hpp"
+
+SGPolicyEvaluator::SGPolicyEvaluator(const SGGame & _game):
+  game(&_game),
+  delta(_game.getDelta()),
+  numStates(_game.getNumStates()),
+  actions(_game.getNumStates(),-1),
+  regimes(_game.getNumStates(),SG::NonBinding),
+  inverse(_game.getNumStates()*_game.getNumStates(),0.0),
+  column(_game.getNumStates(),0.0),
+  row(_game.getNumStates(),0.0),
+  diff(_game.getNumStates(),0.0),
+  numUpdates(0)
+{}
+
+void SGPolicyEvaluator::matrixRow(int state, int action,
+				  SG::Regime regime,
+				  vector<double> & rowOut) const
+{
+  std::fill(rowOut.begin(),rowOut.end(),0.0);
+  if (regime == SG::NonBinding)
+    game->forEachTransition(state,action,[&](int sp, double prob)
+      { rowOut[sp] = -delta*prob; });
+  rowOut[state] += 1.0;
+} // matrixRow
+
+void SGPolicyEvaluator::factorize()
+{
+  // Gauss-Jordan elimination with partial pivoting on [A | I].
+  vector<double> A(numStates*numStates);
+  for (int state = 0; state < numStates; state++)
+    {
+      matrixRow(state,actions[state],regimes[state],row);
+      std::copy(row.begin(),row.end(),A.begin()+state*numStates);
+    }
+  std::fill(inverse.begin(),inverse.end(),0.0);
+  for (int state = 0; state < numStates; state++)
+    inverse[state*numStates+state] = 1.0;
+
+  for (int col = 0; col < numStates; col++)
+    {
+      int pivotRow = col;
+      for (int r = col+1; r < numStates; r++)
+	{
+	  if (abs(A[r*numStates+col]) > abs(A[pivotRow*numStates+col]))
+	    pivotRow = r;
+	}
+      if (abs(A[pivotRow*numStates+col]) < 1e-14)
+	throw(SGException(SG::DIVIDE_BY_ZERO));
+      if (pivotRow != col)
+	{
+	  std::swap_ranges(A.begin()+col*numStates,
+			   A.begin()+(col+1)*numStates,
+			   A.begin()+pivotRow*numStates);
+	  std::swap_ranges(inverse.begin()+col*numStates,
+			   inverse.begin()+(col+1)*numStates,
+			   inverse.begin()+pivotRow*numStates);
+	}
+
+      double scale = 1.0/A[col*numStates+col];
+      for (int c = 0; c < numStates; c++)
+	{
+	  A[col*numStates+c] *= scale;
+	  inverse[col*numStates+c] *= scale;
+	}
+
+      for (int r = 0; r < numStates; r++)
+	{
+	  double factor = A[r*numStates+col];
+	  if (r == col || factor == 0)
+	    continue;
+	  for (int c = 0; c < numStates; c++)
+	    {
+	      A[r*numStates+c] -= factor*A[col*numStates+c];
+	      inverse[r*numStates+c] -= factor*inverse[col*numStates+c];
+	    }
+	}
+    } // col
+
+  numUpdates = 0;
+} // factorize
+
+bool SGPolicyEvaluator::rankOneUpdate(int state, int action,
+				      SG::Regime regime)
+{
+  // The new matrix is A+e_s w', where w is the difference between the
+  // new and the old row. By Sherman-Morrison,
+  // (A+e_s w')^{-1} = A^{-1} - A^{-1}e_s w'A^{-1}/(1+w'A^{-1}e_s).
+  vector<double> & w = diff;
+  matrixRow(state,action,regime,w);
+  matrixRow(state,actions[state],regimes[state],row);
+  for (int sp = 0; sp < numStates; sp++)
+    w[sp] -= row[sp];
+
+  // row = w'A^{-1}, column = A^{-1}e_s
+  std::fill(row.begin(),row.end(),0.0);
+  for (int k = 0; k < numStates; k++)
+    {
+      if (w[k] == 0)
+	continue;
+      const double * invRow = &inverse[k*numStates];
+      for (int c = 0; c < numStates; c++)
+	row[c] += w[k]*invRow[c];
+    }
+  for (int r = 0; r < numStates; r++)
+    column[r] = inverse[r*numStates+state];
+
+  double denom = 1.0 + row[state];
+  if (abs(denom) < 1e-8)
+    return false;
+
+  for (int r = 0; r < numStates; r++)
+    {
+      double factor = column[r]/denom;
+      if (factor == 0)
+	continue;
+      double * invRow = &inverse[r*numStates];
+      for (int c = 0; c < numStates; c++)
+	invRow[c] -= factor*row[c];
+    }
+
+  numUpdates++;
+  return true;
+} // rankOneUpdate
+
+void SGPolicyEvaluator::setPolicy(const vector<int> & newActions,
+				  const vector<SG::Regime> & newRegimes)
+{
+  if (newActions.size() != numStates
+      || newRegimes.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  int numChanged = 0;
+  bool initialized = true;
+  for (int state = 0; state < numStates; state++)
+    {
+      if (actions[state] < 0)
+	initialized = false;
+      if (actions[state] != newActions[state]
+	  || regimes[state] != newRegimes[state])
+	numChanged++;
+    }
+  if (numChanged == 0)
+    return;
+
+  // Rebuild when the policy changes in more than a quarter of the
+  // states, where the update would not be cheaper.
+  if (!initialized
+      || 4*numChanged > numStates
+      || numUpdates + numChanged > maxRankOneUpdates)
+    {
+      actions = newActions;
+      regimes = newRegimes;
+      factorize();
+      return;
+    }
+
+  for (int state = 0; state < numStates; state++)
+    {
+      if (actions[state] == newActions[state]
+	  && regimes[state] == newRegimes[state])
+	continue;
+
+      // Changing the action in a binding state leaves its row of A
+      // unchanged.
+      bool sameRow = (regimes[state] != SG::NonBinding
+		      && newRegimes[state] != SG::NonBinding);
+      if (!sameRow && !rankOneUpdate(state,newActions[state],
+				     newRegimes[state]))
+	{
+	  actions = newActions;
+	  regimes = newRegimes;
+	  factorize();
+	  return;
+	}
+      actions[state] = newActions[state];
+      regimes[state] = newRegimes[state];
+    }
+} // setPolicy
+
+void SGPolicyEvaluator::rightHandSide(const SGTuple & pivot,
+				      SGTuple & rhs) const
+{
+  const vector< vector<SGPoint> > & stagePayoffs = game->getPayoffs();
+
+  // Flow payoffs in non-binding states and the current payoffs in
+  // binding states.
+  rhs = pivot;
+  for (int state = 0; state < numStates; state++)
+    {
+      if (regimes[state] == SG::NonBinding)
+	rhs[state] = (1-delta)*stagePayoffs[state][actions[state]];
+    }
+} // rightHandSide
+
+void SGPolicyEvaluator::statePayoff(int state, const SGTuple & rhs,
+				    SGTuple & pivot) const
+{
+  const double * invRow = &inverse[state*numStates];
+  for (int p = 0; p < game->getNumPlayers(); p++)
+    {
+      double value = 0;
+      for (int sp = 0; sp < numStates; sp++)
+	value += invRow[sp]*rhs[sp][p];
+      pivot[state][p] = value;
+    }
+} // statePayoff
+
+void SGPolicyEvaluator::payoffs(SGTuple & pivot) const
+{
+  if (pivot.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  SGTuple rhs;
+  rightHandSide(pivot,rhs);
+  for (int state = 0; state < numStates; state++)
+    {
+      if (regimes[state] == SG::NonBinding)
+	statePayoff(state,rhs,pivot);
+    }
+} // payoffs
+
+void SGPolicyEvaluator::payoffs(SGTuple & pivot,
+				const vector<int> & states) const
+{
+  if (pivot.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  SGTuple rhs;
+  rightHandSide(pivot,rhs);
+  for (int state : states)
+    {
+      if (regimes[state] == SG::NonBinding)
+	statePayoff(state,rhs,pivot);
+    }
+} // payoffs
+
+void SGPolicyEvaluator::penalties(vector<double> & penalties,
+				  double subGenFactor) const
+{
+  penalties.assign(numStates,subGenFactor);
+  for (int state = 0; state < numStates; state++)
+    {
+      if (regimes[state] != SG::NonBinding)
+	continue;
+      const double * invRow = &inverse[state*numStates];
+      double value = 0;
+      for (int sp = 0; sp < numStates; sp++)
+	value += invRow[sp];
+      penalties[state] = subGenFactor*value;
+    }
+} // penalties
+
+void SGPolicyEvaluator::penalties(vector<double> & penalties,
+				  double subGenFactor,
+				  const vector<int> & states) const
+{
+  if (penalties.size() != numStates)
+    throw(SGException(SG::TUPLE_SIZE_MISMATCH));
+
+  for (int state : states)
+    {
+      penalties[state] = subGenFactor;
+      if (regimes[state] != SG::NonBinding)
+	continue;
+      const double * invRow = &inverse[state*numStates];
+      double value = 0;
+      for (int sp = 0; sp < numStates; sp++)
+	value += invRow[sp];
+      penalties[state] = subGenFactor*value;
+    }
+} // penalties
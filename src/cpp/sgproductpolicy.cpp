@@ -22,18 +22,30 @@
 #include "sgproductpolicy.hpp"
 
 
-std::string SGProductPolicy::hash() const
+void SGProductPolicy::insertPolicy(int state, const SGPolicy & policy)
 {
-  std::string str("F"); // for "face"
-  for (int s = 0; s < policies.size(); s++)
+  if (state >= policies.size() || state<0)
+    throw(SGException(SG::OUT_OF_BOUNDS));
+
+  auto it = std::lower_bound(policies[state].begin(),
+			     policies[state].end(),policy);
+  if (it == policies[state].end() || policy < *it)
     {
-      str += "_";
-      for (auto it = policies[s].cbegin(); it != policies[s].cend(); it++)
-	str += it->hash();
-      str += "_";
-      str += std::to_string(policies[s].size());
+      policies[state].insert(it,policy);
+      key.toggle(policy.getKey());
     }
+} // insertPolicy
 
+void SGProductPolicy::erasePolicy(int state, const SGPolicy & policy)
+{
+  if (state >= policies.size() || state<0)
+    throw(SGException(SG::OUT_OF_BOUNDS));
 
-  return str;
-}
+  auto it = std::lower_bound(policies[state].begin(),
+			     policies[state].end(),policy);
+  if (it != policies[state].end() && !(policy < *it))
+    {
+      policies[state].erase(it);
+      key.toggle(policy.getKey());
+    }
+} // erasePolicy
@@ -79,7 +79,7 @@ void SGSimulator::initialize()
 		= (currentIter->getPivot()[state]
 		   - (1-delta)*soln.getGame().getPayoffs()[state][action])/delta;
 	      SGPoint expPivot
-		= iter->getPivot().expectation(game.getProbabilities()[state][action]);
+		= game.expectation(iter->getPivot(),state,action);
 
 	      if (currentIter->getRegimeTuple()[state] != SG::Binding01)
 		{
@@ -101,8 +101,7 @@ void SGSimulator::initialize()
 		    {
 
 		      SGPoint nextExpPivot
-			= nextIter->getPivot().expectation(game.getProbabilities()
-						      [state][action]);
+			= game.expectation(nextIter->getPivot(),state,action);
 		      SGPoint dir = nextExpPivot - expPivot;
 
 		      double contLevel = dir*continuationValue;
@@ -156,8 +155,7 @@ void SGSimulator::initialize()
 
 		  transitionTableSS << ", binding 0 and 1";
 		  
-		  SGPoint expStartOfLastRev = iter->getPivot()
-		    .expectation(game.getProbabilities()[state][action]);
+		  SGPoint expStartOfLastRev = game.expectation(iter->getPivot(),state,action);
 		  SGPoint direction = continuationValue - expStartOfLastRev,
 		    normal = direction.getNormal();
 		  double level = continuationValue * normal;
@@ -165,8 +163,7 @@ void SGSimulator::initialize()
 		  ++iter;
 		  do
 		    {
-		      expPivot = iter->getPivot()
-			.expectation(game.getProbabilities()[state][action]);
+		      expPivot = game.expectation(iter->getPivot(),state,action);
 			
 		      double newLevel = expPivot * normal;
 		      if (newLevel < level
@@ -174,8 +171,7 @@ void SGSimulator::initialize()
 			  *(expPivot-expStartOfLastRev) > 1e-5)
 			{
 			  list<SGIteration_PencilSharpening>::const_iterator nextIter = (iter--);
-			  SGPoint oldExpPivot = iter->getPivot()
-			    .expectation(game.getProbabilities()[state][action]);
+			  SGPoint oldExpPivot = game.expectation(iter->getPivot(),state,action);
 			  double oldLevel = oldExpPivot*normal;
 			  double weightOnNew
 			    = (level-oldLevel)/(newLevel-oldLevel);
@@ -331,13 +327,30 @@ void SGSimulator::simulate(int _numSim,
 	  probSum = 0;
 	  double stateDraw = distribution(generator);
 	  int newState=0;
-	  while (newState < numStates-1)
+	  if (game.hasSparseTransitions())
 	    {
-	      probSum += soln.getGame().getProbabilities()[currentState]
-		[currentAction][newState];
-	      if (stateDraw < probSum)
-		break;
-	      newState++;
+	      const SGTransitionRow row
+		= game.getTransitionRow(currentState,currentAction);
+	      int k = 0;
+	      while (k < row.nnz-1)
+		{
+		  probSum += row.probs[k];
+		  if (stateDraw < probSum)
+		    break;
+		  k++;
+		}
+	      newState = row.states[k];
+	    }
+	  else
+	    {
+	      while (newState < numStates-1)
+		{
+		  probSum += game.getProbability(currentState,currentAction,
+						 newState);
+		  if (stateDraw < probSum)
+		    break;
+		  newState++;
+		}
 	    }
 
 	  // Update state variables
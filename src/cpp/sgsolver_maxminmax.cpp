@@ -24,6 +24,7 @@
 SGSolver_MaxMinMax::SGSolver_MaxMinMax(const SGEnv & _env,
 			 const SGGame & _game):
   env(_env),
+  tol(_env),
   game(_game),
   soln(_game),
   numPlayers(_game.getNumPlayers()),
@@ -31,9 +32,9 @@ SGSolver_MaxMinMax::SGSolver_MaxMinMax(const SGEnv & _env,
   delta(_game.getDelta()),
   payoffs(_game.getPayoffs()),
   eqActions(_game.getEquilibriumActions()),
-  probabilities(_game.getProbabilities()),
   numActions(_game.getNumActions()),
-  numActions_totalByState(_game.getNumActions_total())
+  numActions_totalByState(_game.getNumActions_total()),
+  evaluator(_game)
 {
 }
 
@@ -43,99 +44,78 @@ void SGSolver_MaxMinMax::solve_fixed()
   initialize();
   
   // Initialize directions
-  int numDirections = 200;
+  int finalNumDirections = 200;
 
   // make an even multiple of 4
-  numDirections += (-numDirections)%4;
+  finalNumDirections += (-finalNumDirections)%4;
+
+  // Start from a coarser set of directions if requested
+  int numDirections = finalNumDirections;
+  if (tol.coarseDirections > 0)
+    numDirections = std::min(finalNumDirections,
+			     4*((tol.coarseDirections+3)/4));
 
   // Initialize directions
-  list<vector< double> > :: const_iterator dueSouthLvl, dueWestLvl;
+  levels.reserve(numDirections);
   for (int dir = 0; dir < numDirections; dir++)
     {
       double theta = 2.0*PI
 	*static_cast<double>(dir)/static_cast<double>(numDirections);
-      directions.push_back(SGPoint(cos(theta),sin(theta)));
-      levels.push_back(vector<double>(numStates,0));
+      levels.push_back(SGPoint(cos(theta),sin(theta)),
+		       vector<double>(numStates,0));
 
     } // for dir
-  
-  {
-    int dirCnt = 0;
-    for (auto lit = levels.cbegin();
-	 lit != levels.cend();
-	 ++lit)
-      {
-	if (dirCnt == numDirections/2)
-	  dueWestLvl = lit;
-	if (dirCnt == 3*numDirections/4)
-	  dueSouthLvl = lit;
-	dirCnt++;
-      }
-  }
+  int dueWestDir = numDirections/2;
+  int dueSouthDir = 3*numDirections/4;
 
   SGTuple pivot = threatTuple;
-  vector<double> penalties (numStates,env.getParam(SG::SUBGENFACTOR));
+  vector<double> penalties (numStates,tol.subGenFactor);
 
   SGIteration_MaxMinMax iter;
+
+  // True if the levels were interpolated by refineDirections rather
+  // than produced by a revolution at the current resolution.
+  bool interpolated = false;
   
-  while (errorLevel > env.getParam(SG::ERRORTOL))
+  while (errorLevel > tol.errorTol)
     {
-      if(numIter >= env.getParam(SG::MAXITERATIONS))
+      if(numIter >= tol.maxIterations)
   	throw(SGException(SG::MAX_ITERATIONS_REACHED));
       else{
-        vector<SGActionIter> actionTuple(numStates);
         // Pick the initial actions arbitrarily
-        for (int state = 0; state < numStates; state++)
-	actionTuple[state] = actions[state].begin();
+        vector<SGActionID> actionTuple(numStates,0);
       
         vector<SG::Regime> regimeTuple(numStates,SG::NonBinding);
 	vector<bool> bestAPSNotBinding(numStates);
 	SGTuple bestBindingPayoffs(numStates);
-	updateBestBinding(actionTuple,regimeTuple,directions.front(),
+	updateBestBinding(actionTuple,regimeTuple,levels.getDirection(0),
 			  bestBindingPayoffs,bestAPSNotBinding);
-	minimizeRegimes(pivot,penalties,actionTuple,regimeTuple,directions.front(),
+	minimizeRegimes(pivot,penalties,actionTuple,regimeTuple,levels.getDirection(0),
 			bestBindingPayoffs,bestAPSNotBinding);
 
-        // Reset the trimmed points for the actions
+        // Reset the trimmed points for the actions. If the initial
+        // action is removed, the first remaining action takes its
+        // place.
         for (int state = 0; state < numStates; state++)
 	  {
-	    auto ait = actions[state].begin();
-	    while (ait != actions[state].end())
-	      {
-	        ait->updateTrim();
-
-	        if (!(ait->supportable() ) )
-		  {
-		    actions[state].erase(ait++);
-		    continue;
-		  }
-	        ait++;
-	      
-	      } // for ait
+	    for (auto & action : actions[state])
+	      action.updateTrim();
 	  } // for state
+	eraseUnsupportableActions();
 
-        if (env.getParam(SG::STOREITERATIONS))
+        if (tol.storeIterations)
 	  iter = SGIteration_MaxMinMax(actions,threatTuple);
       
         // Reset the error level
         errorLevel = 0;
 
         {
-	  list<vector< double> >::iterator lvl;
-	  int dirCnt;
-	  list<SGPoint>::const_iterator dir;
-
 	  // Iterate through directions
-	  for (dir = directions.cbegin(),
-	         lvl = levels.begin(),
-	         dirCnt = 0;
-	       dir != directions.cend(),
-	         lvl != levels.end();
-	       dir++, lvl++, dirCnt ++ )
+	  for (int dir = 0; dir < levels.size(); dir++)
 	    {
 	      // Compute optimal level in this direction
 	      vector<double> newLevels(numStates,0);
-	      SGPoint currDir = *dir;
+	      SGPoint currDir = levels.getDirection(dir);
 
 	      // Make sure payoffs are min-max in new direction
 	      updateBestBinding(actionTuple,regimeTuple,currDir,
@@ -155,72 +135,84 @@ void SGSolver_MaxMinMax::solve_fixed()
 		  // Update the levels and the error level with the
 		  // movement in this direction
 		  newLevels[state] = (pivot[state]*currDir-penalties[state]);
-		  errorLevel = max(errorLevel,abs(newLevels[state]-(*lvl)[state]));
-		  (*lvl)[state] = newLevels[state];
+		  errorLevel = max(errorLevel,abs(newLevels[state]-levels.level(dir,state)));
+		  levels.level(dir,state) = newLevels[state];
 	        } // for state
 
 
-	      if (env.getParam(SG::STOREITERATIONS))
+	      if (tol.storeIterations)
 	        iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
-		  		      SGHyperplane(currDir,newLevels),actions));
+		  		      SGHyperplane(currDir,newLevels)));
 	  
-	    } // for dir lvl dirCntr
+	    } // for dir
         }
 
+        // Move to the next resolution once the error level is below
+        // the distance between a set of this width and the polygon of
+        // numDirections tangent half spaces around it. Further
+        // iterations at this resolution would gain less than the
+        // finer directions.
+        bool refine = false;
+        if (numDirections < finalNumDirections
+	    && numIter > 0)
+	  {
+	    double width = 0;
+	    for (int dir = 0; dir < numDirections/2; dir++)
+	      for (int state = 0; state < numStates; state++)
+		width = std::max(width,levels.level(dir,state)
+				 +levels.level(dir+numDirections/2,state));
+	    refine = (errorLevel < std::max(tol.errorTol,
+					    0.5*width*(1.0/cos(PI/numDirections)-1.0)));
+	  }
+
+        // Only a revolution at the final resolution that started from
+        // levels of a revolution at that resolution can end the
+        // solve. The first revolution after the last refinement
+        // measures the change from the interpolated levels.
+        const bool certifies = (numDirections == finalNumDirections
+				&& !interpolated);
+
         // Update the the threat tuple
         for (int state = 0; state < numStates; state++)
 	  {
-	    threatTuple[state][0] = -(*dueWestLvl)[state];
-	    threatTuple[state][1] = -(*dueSouthLvl)[state];
+	    threatTuple[state][0] = -levels.level(dueWestDir,state);
+	    threatTuple[state][1] = -levels.level(dueSouthDir,state);
 	  }
 
-        if (env.getParam(SG::STOREITERATIONS)==2
-	    || (env.getParam(SG::STOREITERATIONS)==1
-	        && ( errorLevel < env.getParam(SG::ERRORTOL)
-	  	     || numIter+1 >= env.getParam(SG::MAXITERATIONS) ) ) )
+        if (tol.storeIterations==2
+	    || (tol.storeIterations==1
+	        && !refine
+	        && ( (certifies && errorLevel < tol.errorTol)
+	  	     || numIter+1 >= tol.maxIterations ) ) )
 	  soln.push_back(iter); // Important to do this before updating the threat point and minIC of the actions
 
-        // Recalculate minimum IC continuation payoffs
-        for (int state = 0; state < numStates; state++)
+        if (refine)
 	  {
-	    for (auto ait = actions[state].begin();
-	         ait != actions[state].end();
-	         ++ait)
-	      {
-	        ait->calculateMinIC(game,threatTuple);
-	        ait->resetTrimmedPoints();
-	      
-	       {
-	  	  list<SGPoint>::const_iterator dir;
-		  list< vector< double> >::const_iterator lvl;
-		  for (dir = directions.cbegin(),
-		         lvl = levels.cbegin();
-		       dir != directions.cend(),
-		         lvl != levels.cend();
-		       dir++, lvl++)
-		    {
-		      // Compute the expected level
-		      double expLevel = 0;
-		      for (int sp = 0; sp < numStates; sp++)
-		        expLevel += probabilities[state][ait->getAction()][sp]
-			  * (*lvl)[sp];
-		  
-		      // Trim the action
-		      ait->trim(*dir,expLevel);
-		    } // for dir
-	        }
-	      } // for ait
-	  
-	  } // for state
+	    numDirections = std::min(finalNumDirections,2*numDirections);
+	    refineDirections(numDirections);
+	    dueWestDir = numDirections/2;
+	    dueSouthDir = 3*numDirections/4;
+	  }
+
+        // Recalculate minimum IC continuation payoffs
+        trimActions(false);
 
         cout << "Iter: " << numIter
 	     << ", errorLvl: " << scientific << errorLevel
 	     << ", remaining actions: ( ";
         for (int state = 0; state < numStates; state++)
 	  cout << actions[state].size() << " ";
-          cout << ")" << endl;
+          cout << ")";
+        if (refine)
+	  cout << ", refined to " << numDirections << " directions";
+        cout << endl;
       
         numIter++;
+
+        // The levels of the new directions have not been iterated
+        interpolated = refine;
+        if (!certifies)
+	  errorLevel = numeric_limits<double>::max();
       }
     } // while
 
@@ -236,9 +228,9 @@ void SGSolver_MaxMinMax::solve()
     throw(SGException(SG::PROB_SUM_NOT1));
   // Main loop
 
-  while (errorLevel > env.getParam(SG::ERRORTOL))
+  while (errorLevel > tol.errorTol)
   {
-    if(numIter >= env.getParam(SG::MAXITERATIONS))
+    if(numIter >= tol.maxIterations)
       throw(SGException(SG::MAX_ITERATIONS_REACHED));
     else
       {
@@ -261,7 +253,14 @@ std::string SGSolver_MaxMinMax::progressString() const
   for (int state = 0; state < numStates; state++)
     ss << actions[state].size() << " ";
   ss << ")"
-     << ", numDirections = " << directions.size();
+     << ", numDirections = " << levels.size();
+  if (tol.activeSet)
+    {
+      ss << ", active actions: ( ";
+      for (int state = 0; state < numStates; state++)
+	ss << activeActions[state].size() << " ";
+      ss << ")";
+    }
 
   return ss.str();
 }
@@ -269,208 +268,605 @@ std::string SGSolver_MaxMinMax::progressString() const
 
 double SGSolver_MaxMinMax::iterate()
 {
-  SGTuple pivot = threatTuple;
-  vector<double> penalties(numStates,0.0);
-  
   SGIteration_MaxMinMax iter;
   
   // Clear the directions and levels
-  list<SGPoint> newDirections;
-  list< vector<double> > newLevels;
+  SGLevelMatrix newLevels(numPlayers,numStates);
       
-  SGTuple newThreatTuple(threatTuple);
-
-  vector<SGActionIter> actionTuple(numStates);
-  // Pick the initial actions arbitrarily and compute an initial pivot
-  for (int state = 0; state < numStates; state++)
-    actionTuple[state] = actions[state].begin();
+  SGTuple newThreatTuple;
+
+  // With SG::ACTIVESET, the sweep only uses the active actions, and
+  // the arcs on which pricing shows that another action could have
+  // changed it are swept again. The levels of an uncertified sweep
+  // could be too low, and trimActions would then erase actions that
+  // the full sweep keeps.
+  const vector< vector<SGActionID> > * sweepActions
+    = (tol.activeSet? &activeActions : NULL);
+  if (sweepActions)
+    seedActiveActions();
+
+  // Seed directions of the parallel sweep, clockwise from due
+  // north. The first arc starts due north like the serial sweep. The
+  // other seeds are shifted from the even spacing by an irrational
+  // fraction of an arc. Indifference directions often fall exactly
+  // on a cardinal direction, since the IC constraints are
+  // axis-aligned, or on another simple fraction of the circle in a
+  // symmetric game. The serial sweep resolves several indifferences
+  // in one direction by round-off, which an arc ending there would
+  // not reproduce. An arc that is swept again can start up to a
+  // quarter turn before its seed, so arcs other than the last must be
+  // at most a quarter turn, and there are at least four.
+  const int numSegments = (tol.sweepSegments > 0
+			   ? std::max(4,tol.sweepSegments) : 1);
+  const double seedOffset = 0.5*(sqrt(5.0)-1.0);
+  vector<SGPoint> seeds(numSegments);
+  seeds[0] = dueNorth;
+  for (int k = 1; k < numSegments; k++)
+    {
+      const double theta = 2.0*PI*(k-1+seedOffset)/numSegments;
+      seeds[k] = SGPoint(sin(theta),cos(theta));
+    }
+  vector<SweepSegment> segments(numSegments);
 
-  if (env.getParam(SG::STOREITERATIONS))
+  auto samePolicy = [](const SweepPolicy & a, const SweepPolicy & b)
+    {
+      return a.actions == b.actions && a.regimes == b.regimes;
+    };
+  
+  if (tol.storeIterations)
     iter = SGIteration_MaxMinMax (actions,threatTuple);
+
+  if (numSegments == 1)
+    {
+      SweepContext context = {evaluator,pruningStats};
+      sweep(dueNorth,NULL,NULL,segments[0],context,sweepActions);
+    }
+  else
+    {
+      // Each arc gets its own evaluator and counters. The last arc
+      // stops after passing due north, as the serial sweep does.
+      vector<SGPolicyEvaluator> evaluators(numSegments,evaluator);
+      vector<SGPruningStats> stats(numSegments);
+      threadPool->parallelFor(numSegments,[&](int k)
+	{
+	  SweepContext context = {evaluators[k],stats[k]};
+	  sweep(seeds[k],(k+1 < numSegments? &seeds[k+1] : NULL),NULL,
+		segments[k],context,sweepActions);
+	});
+
+      // An arc starts from the policy of the last revolution closest
+      // to its seed direction, while the serial sweep carries the
+      // last step of the previous arc across the seed. The two give
+      // the same directions if the policies are the same and that
+      // step ended at an indifference direction. Otherwise the arc is
+      // swept again from the direction and policy of that step. Its
+      // last step can then change, so the next arc is checked
+      // again. The first arc starts due north like the serial sweep,
+      // so arc k is swept again at most k times.
+      vector<SweepPolicy> startPolicies(numSegments);
+      vector<bool> continued(numSegments,false);
+      while (true)
+	{
+	  vector<int> restart;
+	  for (int k = 1; k < numSegments; k++)
+	    {
+	      if (continued[k])
+		continue;
+	      const SweepPolicy & last = segments[k-1].policies.back();
+	      if (!segments[k-1].capped
+		  && samePolicy(segments[k].policies.front(),last))
+		continued[k] = true;
+	      else
+		{
+		  startPolicies[k] = last;
+		  restart.push_back(k);
+		}
+	    }
+	  if (restart.empty())
+	    break;
+
+	  threadPool->parallelFor(restart.size(),[&](int j)
+	    {
+	      const int k = restart[j];
+	      SweepContext context = {evaluators[k],stats[k]};
+	      sweep(startPolicies[k].dir,(k+1 < numSegments? &seeds[k+1] : NULL),
+		    &startPolicies[k],segments[k],context,sweepActions);
+	    });
+	  pruningStats.arcsRestarts += restart.size();
+	  for (int k : restart)
+	    continued[k] = true;
+	  for (int k : restart)
+	    {
+	      if (k+1 < numSegments)
+		continued[k+1] = false;
+	    }
+	} // while
+      for (int k = 0; k < numSegments; k++)
+	pruningStats += stats[k];
+    }
+
+  // Each arc ends at the seed direction at which the next one
+  // starts, or which it crosses in its first step. The serial sweep
+  // only stops there if the policy changes, so a segment is joined
+  // with the next one, and the seed direction is dropped, if the next
+  // one starts with the same policy.
+  vector<bool> joinNext(numSegments,true);
+
+  if (sweepActions)
+    {
+      // Split the sweep into one segment per arc, and sweep again
+      // the arcs on which pricing added an action. Only the new arcs
+      // are priced in the next pass, since the others were priced
+      // against every action that is still inactive. Except at the
+      // end of the circle, the last arc of a segment or of a new
+      // sweep ends at a seed direction or where the old arc did.
+      // Neither is an indifference direction, so it is joined with
+      // the next arc like the segments above.
+      vector<SweepSegment> pieces;
+      joinNext.clear();
+      for (const SweepSegment & segment : segments)
+	{
+	  splitSegment(segment,pieces);
+	  joinNext.resize(pieces.size(),false);
+	  joinNext.back() = true;
+	}
+      vector<int> unpriced(pieces.size());
+      for (int k = 0; k < pieces.size(); k++)
+	unpriced[k] = k;
+
+      vector<SweepArc> arcs;
+      vector<bool> added;
+      while (true)
+	{
+	  arcs.clear();
+	  for (int k : unpriced)
+	    arcs.push_back(pieces[k].arcs[0]);
+	  if (priceActions(arcs,added) == 0)
+	    break;
+
+	  vector<int> resweep;
+	  for (int j = 0; j < unpriced.size(); j++)
+	    {
+	      if (added[j])
+		resweep.push_back(unpriced[j]);
+	    }
+	  vector<SweepSegment> resweeps(resweep.size());
+	  vector<SGPolicyEvaluator> evaluators(resweep.size(),evaluator);
+	  vector<SGPruningStats> stats(resweep.size());
+	  threadPool->parallelFor(resweep.size(),[&](int j)
+	    {
+	      const SweepArc & arc = pieces[resweep[j]].arcs[0];
+	      SweepContext context = {evaluators[j],stats[j]};
+	      sweep(arc.dir,&arc.endDir,NULL,resweeps[j],context,sweepActions);
+	    });
+	  pruningStats.arcsResweeps += resweep.size();
+
+	  // Replace the arcs that were swept again
+	  vector<SweepSegment> newPieces;
+	  vector<bool> newJoinNext;
+	  unpriced.clear();
+	  for (int k = 0, j = 0; k < pieces.size(); k++)
+	    {
+	      if (j < resweep.size() && resweep[j] == k)
+		{
+		  pruningStats += stats[j];
+		  const int numPieces = newPieces.size();
+		  splitSegment(resweeps[j],newPieces);
+		  for (int i = numPieces; i < newPieces.size(); i++)
+		    unpriced.push_back(i);
+		  newJoinNext.resize(newPieces.size(),false);
+		  newJoinNext.back() = true;
+		  j++;
+		}
+	      else
+		{
+		  newPieces.push_back(std::move(pieces[k]));
+		  newJoinNext.push_back(joinNext[k]);
+		}
+	    }
+	  pieces.swap(newPieces);
+	  joinNext.swap(newJoinNext);
+	} // while
+      segments.swap(pieces);
+    }
+
+  // Join the segments in clockwise order. Each raises the threat
+  // tuple only where it crosses due west or due south.
+  newThreatTuple = threatTuple;
+  lastPolicies.clear();
+  bool joinPrev = false;
+  for (int k = 0; k < segments.size(); k++)
+    {
+      const SweepSegment & segment = segments[k];
+      const bool join = (joinNext[k] && k+1 < segments.size()
+			 && samePolicy(segment.policies.back(),
+				       segments[k+1].policies.front()));
+      const int numDirs = segment.levels.size() - (join? 1 : 0);
+      for (int d = 0; d < numDirs; d++)
+	newLevels.push_back(segment.levels.getDirection(d),
+			    segment.levels.getLevels(d));
+      for (int d = 0; d < segment.steps.size() && d < numDirs; d++)
+	iter.push_back(segment.steps[d]);
+      lastPolicies.insert(lastPolicies.end(),
+			  segment.policies.begin() + (joinPrev? 1 : 0),
+			  segment.policies.end());
+      for (int state = 0; state < numStates; state++)
+	newThreatTuple[state].max(segment.threatTuple[state]);
+      joinPrev = join;
+    }
+
+  // Recompute the error level
+  errorLevel = pseudoHausdorff(newLevels);
   
-  // Iterate through directions
-  SGPoint currDir = SGPoint(0.0,1.0); // Start pointing due north
-  bool passNorth = false;
+  if (tol.storeIterations==2
+      || (tol.storeIterations==1
+	  && ( errorLevel < tol.errorTol
+	       || numIter+1 >= tol.maxIterations ) ) )
+    soln.push_back(iter); // Important to do this before updating the threat point and minIC of the actions
 
-  // Construct initial pivot
+  // Update the the threat tuple, directions, levels
+  threatTuple = newThreatTuple;
+  levels = newLevels;
+
+  // TODO: Add another parameter to control convergence criterion
+  // // Recalculate minimum IC continuation payoffs
+  // errorLevel = 0.0;
+  
+  trimActions(true);
+
+  // Delete the actions that are not supportable
+  eraseUnsupportableActions();
+
+  numIter++;
+  return errorLevel;
+  
+} // iterate
+
+template<bool doInner>
+void SGSolver_MaxMinMax::sweep(const SGPoint & startDir,
+			       const SGPoint * endDir,
+			       const SweepPolicy * startPolicy,
+			       SweepSegment & segment,
+			       SweepContext & context,
+			       const vector< vector<SGActionID> > * activeActions) const
+{
+  SGTuple pivot = threatTuple;
+  vector<double> penalties(numStates,0.0);
+
+  segment.levels = SGLevelMatrix(numPlayers,numStates);
+  segment.steps.clear();
+  segment.arcs.clear();
+  segment.policies.clear();
+  segment.threatTuple = threatTuple;
+  segment.capped = false;
 
-  // Start with all regimes non-binding (needed so that
-  // updateBestBinding will set the binding payoffs)
-  vector<SG::Regime> regimeTuple(numStates,SG::NonBinding);
+  // Iterate through directions
+  SGPoint currDir = startDir;
+  bool done = false;
+
+  vector<SGActionID> actionTuple, seedActions;
+  vector<SG::Regime> regimeTuple, seedRegimes;
   vector<bool> bestAPSNotBinding(numStates,false);
   SGTuple bestBindingPayoffs(numStates);
+  int closest = -1;
 
-  // Update the best binding payoffs
-  updateBestBinding(actionTuple,regimeTuple,currDir,
-		    bestBindingPayoffs,bestAPSNotBinding);
-  // minimize regimes
-  minimizeRegimes(pivot,penalties,actionTuple,regimeTuple,currDir,
-		  bestBindingPayoffs,bestAPSNotBinding);
+  // Switches to the seed policy and computes its pivot in currDir.
+  // Regimes start non-binding so that updateBestBinding sets all of
+  // the binding payoffs.
+  auto seed = [&]()
+    {
+      actionTuple = seedActions;
+      regimeTuple.assign(numStates,SG::NonBinding);
+      updateBestBinding(actionTuple,regimeTuple,currDir,
+			bestBindingPayoffs,bestAPSNotBinding);
+      for (int state = 0; state < numStates; state++)
+	{
+	  if (seedRegimes[state] == SG::Binding && !bestAPSNotBinding[state])
+	    {
+	      regimeTuple[state] = SG::Binding;
+	      pivot[state] = bestBindingPayoffs[state];
+	    }
+	}
+      minimizeRegimes<doInner>(pivot,penalties,actionTuple,regimeTuple,currDir,
+			       bestBindingPayoffs,bestAPSNotBinding,context);
+    };
 
-  while (!passNorth)
+  // Construct initial pivot
+  if (startPolicy)
+    unpackPolicy(*startPolicy,seedActions,seedRegimes);
+  else
+    seedPolicy(currDir,closest,seedActions,seedRegimes);
+  seed();
+
+  bool firstDir = true;
+  while (!done)
     {
+      // The current policy is only tied with the optimum at currDir,
+      // while the policy of the last revolution in the closest
+      // direction is usually optimal once the iterates settle down.
+      if (!firstDir
+	  && seedPolicy(currDir,closest,seedActions,seedRegimes)
+	  && seedActions != actionTuple)
+	seed();
+      firstDir = false;
+
       // Compute optimal level in this direction
-      robustOptimizePolicy(pivot,penalties,
-			   actionTuple,
-			   regimeTuple,
-			   bestAPSNotBinding,
-			   bestBindingPayoffs,
-			   currDir,
-			   actions);
+      robustOptimizePolicy<doInner>(pivot,penalties,
+				    actionTuple,
+				    regimeTuple,
+				    bestAPSNotBinding,
+				    bestBindingPayoffs,
+				    currDir,
+				    actions,activeActions,context);
+
+      SweepPolicy policy = {currDir,vector<int>(numStates),regimeTuple};
+      for (int state = 0; state < numStates; state++)
+	policy.actions[state] = actions[state][actionTuple[state]].getAction();
+      segment.policies.push_back(policy);
 
       // Do sensitivity analysis to find the next direction
       SGPoint normDir = -1.0*currDir.getNormal(); // rotate direction clockwise 90 degrees
-      double bestLevel = sensitivity(pivot,penalties,actionTuple,regimeTuple,
-				     currDir,actions);
+      double bestLevel = sensitivity<doInner>(pivot,penalties,actionTuple,regimeTuple,
+					      currDir,actions,activeActions,context);
 
       SGPoint newDir = 1.0/(bestLevel+1.0)*currDir
 	+ bestLevel/(bestLevel+1.0)*normDir;
       newDir /= newDir.norm();
-	  
-      newLevels.push_back(vector<double>(numStates,0));
-      newDirections.push_back(newDir);
-      for (int state = 0; state < numStates; state++)
-	{
-	  newLevels.back()[state] = (pivot[state]*newDir-penalties[state]);
-	} // for state
-      if (env.getParam(SG::STOREITERATIONS))
-	iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
-			      SGHyperplane(newDir,newLevels.back()),actions));
-      
-      // Move the direction slightly to break ties
-      // newDir.rotateCW(PI*1e-4);
+      segment.capped = (bestLevel >= numeric_limits<double>::max()-1.0);
 
-      // If new direction passes due west or due south, update the
-      // corresponding threat tuple using the current pivot
-      if (currDir*dueNorth < 0 && newDir*dueNorth >= 0) // Passing due west
+      // Stop at the end of the arc. The pivot is optimal up to
+      // newDir, so it is also optimal at endDir.
+      if (endDir
+	  && (*endDir)[0]*newDir[1] - (*endDir)[1]*newDir[0] <= 0)
 	{
-	  for (int state = 0; state < numStates; state++)
-	    newThreatTuple[state][0] = max(pivot[state][0]+penalties[state],threatTuple[state][0]);
+	  newDir = *endDir;
+	  done = true;
 	}
-      else if (currDir*dueEast > 0 && newDir*dueEast <= 0) // Passing due south
+
+      vector<double> newDirLevels(numStates,0);
+      for (int state = 0; state < numStates; state++)
 	{
-	  for (int state = 0; state < numStates; state++)
-	    newThreatTuple[state][1] = max(pivot[state][1]+penalties[state],threatTuple[state][1]);
+	  newDirLevels[state] = (pivot[state]*newDir-penalties[state]);
+	} // for state
+      segment.levels.push_back(newDir,newDirLevels);
+      if (tol.storeIterations)
+	segment.steps.push_back(SGStep(actionTuple,regimeTuple,pivot,
+				       SGHyperplane(newDir,newDirLevels)));
+      if (activeActions)
+	{
+	  SweepArc arc = {currDir,newDir,pivot,penalties};
+	  segment.arcs.push_back(arc);
 	}
-      else if (currDir*dueEast < 0 && newDir*dueEast >= 0)
-	passNorth = true;
-	  
+
+      if (updateThreats(currDir,newDir,pivot,penalties,segment.threatTuple))
+	done = true;
+
       currDir = newDir;
     } // while
+} // sweep
 
-  // Recompute the error level
-  errorLevel = pseudoHausdorff(newDirections,newLevels);
-  
-  if (env.getParam(SG::STOREITERATIONS)==2
-      || (env.getParam(SG::STOREITERATIONS)==1
-	  && ( errorLevel < env.getParam(SG::ERRORTOL)
-	       || numIter+1 >= env.getParam(SG::MAXITERATIONS) ) ) )
-    soln.push_back(iter); // Important to do this before updating the threat point and minIC of the actions
+bool SGSolver_MaxMinMax::updateThreats(const SGPoint & currDir,
+				       const SGPoint & newDir,
+				       const SGTuple & pivot,
+				       const vector<double> & penalties,
+				       SGTuple & threats) const
+{
+  // If new direction passes due west or due south, update the
+  // corresponding threat tuple using the current pivot
+  if (currDir*dueNorth < 0 && newDir*dueNorth >= 0) // Passing due west
+    {
+      for (int state = 0; state < numStates; state++)
+	threats[state][0] = max(pivot[state][0]+penalties[state],
+				threatTuple[state][0]);
+    }
+  else if (currDir*dueEast > 0 && newDir*dueEast <= 0) // Passing due south
+    {
+      for (int state = 0; state < numStates; state++)
+	threats[state][1] = max(pivot[state][1]+penalties[state],
+				threatTuple[state][1]);
+    }
+  else if (currDir*dueEast < 0 && newDir*dueEast >= 0)
+    return true; // Passing due north
+  return false;
+} // updateThreats
 
-  // Update the the threat tuple, directions, levels
-  threatTuple = newThreatTuple;
-  directions = newDirections;
-  levels = newLevels;
+void SGSolver_MaxMinMax::splitSegment(const SweepSegment & segment,
+				      vector<SweepSegment> & pieces) const
+{
+  // Each arc has one direction and level at its end, one policy at
+  // its start and, if iterations are stored, one step.
+  for (int d = 0; d < segment.arcs.size(); d++)
+    {
+      const SweepArc & arc = segment.arcs[d];
+      pieces.push_back(SweepSegment());
+      SweepSegment & piece = pieces.back();
+      piece.levels = SGLevelMatrix(numPlayers,numStates);
+      piece.levels.push_back(segment.levels.getDirection(d),
+			     segment.levels.getLevels(d));
+      if (tol.storeIterations)
+	piece.steps.push_back(segment.steps[d]);
+      piece.arcs.push_back(arc);
+      piece.threatTuple = threatTuple;
+      updateThreats(arc.dir,arc.endDir,arc.pivot,arc.penalties,
+		    piece.threatTuple);
+      piece.policies.push_back(segment.policies[d]);
+    }
+} // splitSegment
+
+void SGSolver_MaxMinMax::sweep(const SGPoint & startDir,
+			       const SGPoint * endDir,
+			       const SweepPolicy * startPolicy,
+			       SweepSegment & segment,
+			       SweepContext & context,
+			       const vector< vector<SGActionID> > * activeActions) const
+{
+  if (tol.doInner())
+    sweep<true>(startDir,endDir,startPolicy,segment,context,activeActions);
+  else
+    sweep<false>(startDir,endDir,startPolicy,segment,context,activeActions);
+} // sweep
+
+bool SGSolver_MaxMinMax::seedPolicy(const SGPoint & dir, int & closest,
+				    vector<SGActionID> & actionTuple,
+				    vector<SG::Regime> & regimeTuple) const
+{
+  actionTuple.assign(numStates,0);
+  regimeTuple.assign(numStates,SG::NonBinding);
+  if (lastPolicies.empty())
+    return false;
 
-  // TODO: Add another parameter to control convergence criterion
-  // // Recalculate minimum IC continuation payoffs
-  // errorLevel = 0.0;
-  
-  for (int state = 0; state < numStates; state++)
+  const int numPolicies = lastPolicies.size();
+  if (closest < 0 || closest >= numPolicies)
     {
-      for (auto ait = actions[state].begin();
-	   ait != actions[state].end();
-	   ++ait)
+      closest = 0;
+      for (int k = 1; k < numPolicies; k++)
 	{
-	  ait->calculateMinIC(game,threatTuple);
-	  ait->resetTrimmedPoints();
-
-	  // Trim the actions
-	  auto dir = directions.cbegin();
-	  auto lvl = levels.cbegin();
-	  while (dir != directions.cend()
-		 && lvl != levels.cend())
-	    {
-	      // Trim the action
-	      double expLevel = 0;
-	      for (int sp = 0; sp < numStates; sp++)
-		expLevel += probabilities[state][ait->getAction()][sp]
-		  * (*lvl)[sp];
-
-	      ait->trim(*dir,expLevel);
-
-	      dir++;
-	      lvl++;
-	    } // for dir, lvl
-
-	  // errorLevel = max(errorLevel,ait->distToTrimmed());
-	  
-	  ait->updateTrim();
+	  if (lastPolicies[k].dir*dir > lastPolicies[closest].dir*dir)
+	    closest = k;
+	}
+    }
+  else
+    {
+      // The directions are in clockwise order, and so are the calls
+      // in a sweep.
+      for (int steps = 0; steps < numPolicies; steps++)
+	{
+	  const int next = (closest+1)%numPolicies;
+	  if (lastPolicies[next].dir*dir <= lastPolicies[closest].dir*dir)
+	    break;
+	  closest = next;
+	}
+    }
+  unpackPolicy(lastPolicies[closest],actionTuple,regimeTuple);
+  return true;
+} // seedPolicy
 
-	} // for ait
-	  
-    } // for state
+void SGSolver_MaxMinMax::unpackPolicy(const SweepPolicy & policy,
+				      vector<SGActionID> & actionTuple,
+				      vector<SG::Regime> & regimeTuple) const
+{
+  actionTuple.assign(numStates,0);
+  regimeTuple.assign(numStates,SG::NonBinding);
+  for (int state = 0; state < numStates; state++)
+    {
+      const SGActionID id = findAction(actions[state],policy.actions[state]);
+      if (id >= 0)
+	{
+	  actionTuple[state] = id;
+	  regimeTuple[state] = policy.regimes[state];
+	}
+    }
+} // unpackPolicy
 
+void SGSolver_MaxMinMax::trimActions(bool update)
+{
+  // Split each state's actions into chunks. Within a state, actions
+  // are sorted by transition row, so actions that share a row are
+  // adjacent, and the expected levels of each distinct row in a chunk
+  // are computed once, in one call to SGLevelMatrix::expectedLevels.
+  const int chunkSize = 32;
+  vector< vector<SGAction_MaxMinMax *> > chunks;
   for (int state = 0; state < numStates; state++)
     {
-      auto ait = actions[state].begin();
-      while (ait != actions[state].end())
+      vector<SGAction_MaxMinMax *> stateActions(actions[state].size());
+      for (SGActionID id = 0; id < actions[state].size(); id++)
+	stateActions[id] = &actions[state][id];
+      std::stable_sort(stateActions.begin(),stateActions.end(),
+		       [&](const SGAction_MaxMinMax * a0,
+			   const SGAction_MaxMinMax * a1)
+		       {
+			 return (game.getTransitionRowID(state,a0->getAction())
+				 < game.getTransitionRowID(state,a1->getAction()));
+		       });
+
+      for (int i = 0; i < stateActions.size(); i++)
 	{
-	  // Delete the action if not supportable
-	  if (!(ait->supportable()))
-	    {
-	      actions[state].erase(ait++);
-	      continue;
-	    }
-	  ++ait;
-	} // while ait
-	  
-    } // for state
+	  if (i == 0
+	      || chunks.back().size() == chunkSize)
+	    chunks.push_back(vector<SGAction_MaxMinMax *>());
+	  chunks.back().push_back(stateActions[i]);
+	}
+    }
 
-  numIter++;
-  return errorLevel;
-  
-} // iterate
+  vector<SGPoint> dirs(levels.size());
+  for (int d = 0; d < levels.size(); d++)
+    dirs[d] = levels.getDirection(d);
 
-double SGSolver_MaxMinMax::pseudoHausdorff(const list<SGPoint> & newDirections,
-					   const list<vector<double> > & newLevels) const
-{
-  // Recompute the error level
-  double newErrorLevel = 0;
-  // Rather heavy handed, but do this for now.
+  // Minimum IC continuation values of every action profile
+  vector< vector<SGPoint> > minICs(numStates);
+  threadPool->parallelFor(numStates,[&](int state)
+    {
+      game.minICPayoffs(state,threatTuple,minICs[state]);
+    });
 
-  auto dir0 = directions.cbegin(), dir1 = newDirections.cbegin();
-  auto lvl0 = levels.cbegin(), lvl1 = newLevels.cbegin();
-  while (dir1 != newDirections.cend()
-	 && lvl1 != newLevels.cend())
+  threadPool->parallelFor(chunks.size(),[&](int c)
     {
-      dir0 = directions.cbegin();
-      lvl0 = levels.cbegin();
-      double minDist = numeric_limits<double>::max();
-      while (dir0 != directions.cend()
-	     && lvl0 != levels.cend() )
+      const vector<SGAction_MaxMinMax *> & chunk = chunks[c];
+      const int stride = levels.getStride();
+
+      // Distinct transition rows in the chunk, and the row of each
+      // action.
+      vector<const SGAction_MaxMinMax *> rowActions;
+      vector<int> rowIndex(chunk.size());
+      for (int i = 0; i < chunk.size(); i++)
 	{
-	  double tmp = 0;
-	  for (int state = 0; state < numStates; state++)
-	    tmp = max(tmp,abs((*lvl0)[state]-(*lvl1)[state]));
-		  
-	  minDist = min(minDist,SGPoint::distance(*dir0,*dir1)+tmp);
-		  
-	  dir0++;
-	  lvl0++;
+	  if (i == 0
+	      || (game.getTransitionRowID(chunk[i]->getState(),chunk[i]->getAction())
+		  != game.getTransitionRowID(chunk[i-1]->getState(),
+					     chunk[i-1]->getAction())))
+	    rowActions.push_back(chunk[i]);
+	  rowIndex[i] = rowActions.size()-1;
 	}
-      newErrorLevel = max(newErrorLevel,minDist);
-	      
-      dir1++;
-      lvl1++;
-    }
-  return newErrorLevel;
+
+      SGLevelMatrix::AlignedVector expLevels(rowActions.size()*stride);
+      if (game.hasSparseTransitions())
+	{
+	  vector<SGTransitionRow> rows(rowActions.size());
+	  for (int r = 0; r < rowActions.size(); r++)
+	    rows[r] = game.getTransitionRow(rowActions[r]->getState(),
+					    rowActions[r]->getAction());
+	  levels.expectedLevels(rows,expLevels.data());
+	}
+      else
+	{
+	  vector<const vector<double> *> probs(rowActions.size());
+	  for (int r = 0; r < rowActions.size(); r++)
+	    probs[r] = &game.getDenseTransitionRow(rowActions[r]->getState(),
+						   rowActions[r]->getAction());
+	  levels.expectedLevels(probs,expLevels.data());
+	}
+
+      for (int i = 0; i < chunk.size(); i++)
+	{
+	  SGAction_MaxMinMax & action = *chunk[i];
+	  action.setMinICPayoffs(minICs[action.getState()][action.getAction()]);
+	  action.resetTrimmedPoints();
+
+	  const double * actionLevels = &expLevels[rowIndex[i]*stride];
+	  for (int d = 0; d < dirs.size(); d++)
+	    action.trim(dirs[d],actionLevels[d]);
+
+	  if (update)
+	    action.updateTrim();
+	}
+    });
+} // trimActions
+
+double SGSolver_MaxMinMax::pseudoHausdorff(const SGLevelMatrix & newLevels) const
+{
+  return SGLevelMatrix::pseudoHausdorff(newLevels,levels);
 }
 
 void SGSolver_MaxMinMax::initialize()
 {
+  tol = SGEnvSnapshot(env);
+  pruningStats.reset();
+  
   errorLevel = 1;
   numIter = 0;
+  lastPolicies.clear();
+
+  threadPool = std::make_shared<SGThreadPool>(env.getParam(SG::NUMTHREADS));
   
   SGPoint payoffLB, payoffUB;
   game.getPayoffBounds(payoffUB,payoffLB);
@@ -479,33 +875,35 @@ void SGSolver_MaxMinMax::initialize()
 
   // Clear the solution
   soln.clear();
-  directions.clear();
-  levels.clear();
+  levels = SGLevelMatrix(numPlayers,numStates);
   
   // Initialize actions with a big box as the feasible set
   actions.clear();
-  actions = vector< list<SGAction_MaxMinMax> > (numStates);
+  actions = vector< vector<SGAction_MaxMinMax> > (numStates);
   
   for (int state = 0; state < numStates; state++)
     {
+      actions[state].reserve(numActions_totalByState[state]);
       if (eqActions[state].size()>0)
 	{
 	  for (int a=0; a<numActions_totalByState[state]; a++)
 	    {
 	      if (eqActions[state][a])
-		actions[state].push_back(SGAction_MaxMinMax(env,state,a));
+		actions[state].push_back(SGAction_MaxMinMax(tol,state,a));
 	    }
 	}
       else
 	{
 	  for (int a=0; a<numActions_totalByState[state]; a++)
-	    actions[state].push_back(SGAction_MaxMinMax(env,state,a));
+	    actions[state].push_back(SGAction_MaxMinMax(tol,state,a));
 	}
       
-      for (auto ait = actions[state].begin(); ait != actions[state].end(); ait++)
+      vector<SGPoint> minICs;
+      game.minICPayoffs(state,threatTuple,minICs);
+      for (auto & action : actions[state])
 	{
-	  ait->calculateMinIC(game,threatTuple);
-	  ait->resetTrimmedPoints();
+	  action.setMinICPayoffs(minICs[action.getAction()]);
+	  action.resetTrimmedPoints();
 	  
 	  for (int dir = 0; dir < 4; dir ++)
 	    {
@@ -513,39 +911,169 @@ void SGSolver_MaxMinMax::initialize()
 	      SGPoint currDir = SGPoint(cos(theta),sin(theta));
 
 	      double level = max(currDir*payoffLB,currDir*payoffUB);
-	      ait->trim(currDir,level);
+	      action.trim(currDir,level);
 	    } // for dir
 
-	  ait->updateTrim();
+	  action.updateTrim();
 	}
     } // for state
 
-  for (int state = 0; state < numStates; state++)
+  // Delete the actions that are not supportable
+  eraseUnsupportableActions(true);
+
+  // Seed the active actions of the first revolution, which has no
+  // policies to start from, with the first action and the best stage
+  // payoffs in the cardinal directions.
+  if (tol.activeSet)
     {
-      auto ait = actions[state].begin();
-      while (ait != actions[state].end())
+      const SGPoint cardinalDirs[4] = {dueNorth,dueEast,-1.0*dueNorth,-1.0*dueEast};
+      vector<SGActionID> best, nearBest;
+      for (int state = 0; state < numStates; state++)
 	{
-	  // Delete the action if not supportable
-	  if (!(ait->supportable()))
+	  vector<SGActionID> & active = activeActions[state];
+	  active.clear();
+	  if (actions[state].empty())
+	    continue;
+	  active.push_back(0);
+	  for (int g = 0; g < hulls[state].size(); g++)
 	    {
-	      actions[state].erase(ait++);
-	      continue;
+	      for (const SGPoint & dir : cardinalDirs)
+		{
+		  hulls[state].bestActions(g,dir,best,nearBest);
+		  active.insert(active.end(),best.begin(),best.end());
+		}
 	    }
-	  ++ait;
-	} // while ait
-	  
-    } // for state
+	  std::sort(active.begin(),active.end());
+	  active.erase(std::unique(active.begin(),active.end()),active.end());
+	}
+    }
 
 } // initialize
 
+void SGSolver_MaxMinMax::eraseUnsupportableActions(bool rebuild)
+{
+  // Renumber the active actions to match the erasure. The first
+  // action stays active, since iterate() starts from it.
+  activeActions.resize(numStates);
+  if (tol.activeSet)
+    {
+      for (int state = 0; state < numStates; state++)
+	{
+	  vector<SGActionID> newIDs(actions[state].size(),-1);
+	  SGActionID numKept = 0;
+	  for (SGActionID id = 0; id < actions[state].size(); id++)
+	    {
+	      if (actions[state][id].supportable())
+		newIDs[id] = numKept++;
+	    }
+	  vector<SGActionID> & active = activeActions[state];
+	  int numActive = 0;
+	  for (SGActionID id : active)
+	    {
+	      if (newIDs[id] >= 0)
+		active[numActive++] = newIDs[id];
+	    }
+	  active.resize(numActive);
+	  if (numKept > 0 && (active.empty() || active[0] != 0))
+	    active.insert(active.begin(),0);
+	}
+    }
+
+  // Non-binding payoffs in a group differ by (1-delta) times the
+  // difference in stage payoffs. Stage payoffs that are this close
+  // can be reordered by the tolerances in lexComp.
+  const double hullTol = 2.0*(tol.lexImproveTol+tol.lexSubOpTol)/(1-delta);
+
+  hulls.resize(numStates);
+  for (int state = 0; state < numStates; state++)
+    {
+      if (eraseUnsupportable(actions[state]) > 0 || rebuild)
+	hulls[state] = SGHullIndex(game,state,actions[state],hullTol);
+    }
+} // eraseUnsupportableActions
+
+void SGSolver_MaxMinMax::seedActiveActions()
+{
+  if (lastPolicies.empty())
+    return;
+
+  vector<SGActionID> ids;
+  for (int state = 0; state < numStates; state++)
+    {
+      vector<SGActionID> & active = activeActions[state];
+      active.clear();
+      if (actions[state].empty())
+	continue;
+
+      // The policies record the actions by their index in the game.
+      ids.assign(numActions_totalByState[state],-1);
+      for (SGActionID id = 0; id < actions[state].size(); id++)
+	ids[actions[state][id].getAction()] = id;
+
+      active.push_back(0);
+      for (const SweepPolicy & policy : lastPolicies)
+	{
+	  const SGActionID id = ids[policy.actions[state]];
+	  if (id >= 0)
+	    active.push_back(id);
+	}
+      std::sort(active.begin(),active.end());
+      active.erase(std::unique(active.begin(),active.end()),active.end());
+    }
+} // seedActiveActions
+
+void SGSolver_MaxMinMax::refineDirections(int numDirections)
+{
+  const int oldNumDirections = levels.size();
+  if (numDirections < oldNumDirections
+      || oldNumDirections%4 != 0
+      || oldNumDirections == 0)
+    throw(SGException(SG::OUT_OF_BOUNDS));
+
+  SGLevelMatrix newLevels(numPlayers,numStates);
+  newLevels.reserve(numDirections);
+  vector<double> dirLevels(numStates);
+  for (int dir = 0; dir < numDirections; dir++)
+    {
+      double theta = 2.0*PI
+	*static_cast<double>(dir)/static_cast<double>(numDirections);
+      SGPoint newDir(cos(theta),sin(theta));
+
+      // The old direction at or before theta, and the one after it
+      const int d1 = (dir*oldNumDirections)/numDirections;
+      if ((dir*oldNumDirections)%numDirections == 0)
+	{
+	  for (int state = 0; state < numStates; state++)
+	    dirLevels[state] = levels.level(d1,state);
+	}
+      else
+	{
+	  const int d2 = (d1+1)%oldNumDirections;
+	  const SGPoint dir1 = levels.getDirection(d1);
+	  const SGPoint dir2 = levels.getDirection(d2);
+	  const double det = dir1[0]*dir2[1]-dir1[1]*dir2[0];
+	  const double a = (newDir[0]*dir2[1]-newDir[1]*dir2[0])/det;
+	  const double b = (dir1[0]*newDir[1]-dir1[1]*newDir[0])/det;
+	  for (int state = 0; state < numStates; state++)
+	    dirLevels[state] = a*levels.level(d1,state)+b*levels.level(d2,state);
+	}
+      newLevels.push_back(newDir,dirLevels);
+    } // for dir
+
+  levels = newLevels;
+} // refineDirections
+
+template<bool doInner>
 void SGSolver_MaxMinMax::robustOptimizePolicy(SGTuple & pivot,
 					      vector<double> & penalties,
-					      vector<SGActionIter> & actionTuple,
+					      vector<SGActionID> & actionTuple,
 					      vector<SG::Regime> & regimeTuple,
 					      vector<bool> & bestAPSNotBinding,
 					      SGTuple & bestBindingPayoffs,
 					      const SGPoint currDir,
-					      const vector<list<SGAction_MaxMinMax> > & actions) const
+					      const vector< vector<SGAction_MaxMinMax> > & actions,
+					      const vector< vector<SGActionID> > * activeActions,
+					      SweepContext & context) const
 {
   // Do policy iteration to find the optimal pivot.
   bool actionsChanged;
@@ -554,119 +1082,338 @@ void SGSolver_MaxMinMax::robustOptimizePolicy(SGTuple & pivot,
   SGTuple newPivot(pivot);
   vector<double> newPenalties(penalties);
 
-  vector<SGActionIter> newActionTuple(actionTuple);
+  vector<SGActionID> newActionTuple(actionTuple);
   vector<SG::Regime> newRegimeTuple(regimeTuple);
   
-  bool doInner = env.getParam(SG::SUBGENFACTOR)>0;
-  double bindingPenalty = 0;
-  if (doInner)
-    bindingPenalty = env.getParam(SG::SUBGENFACTOR);
+  const double bindingPenalty = (doInner? tol.subGenFactor : 0.0);
+
+  // Expectations only depend on the transition row, so they are
+  // computed once per row in each sweep.
+  SGExpectationCache cache(game);
+  vector<SGActionID> best, nearBest, candidates;
+  vector<double> bounds, remainingBounds;
+
+  // Upper bounds on the levels of the binding payoffs. These do not
+  // depend on the pivot, so they are computed once per direction,
+  // and only for the active actions if there are any.
+  vector< vector<double> > bindingBounds(numStates);
+  for (int state = 0; state < numStates; state++)
+    {
+      bindingBounds[state].resize(actions[state].size());
+      auto setBound = [&](SGActionID id)
+	{
+	  bindingBounds[state][id] = delta*maxBindingLevel(actions[state][id],
+							   currDir)
+	    - bindingPenalty;
+	};
+      if (activeActions)
+	{
+	  for (SGActionID id : (*activeActions)[state])
+	    setBound(id);
+	}
+      else
+	{
+	  for (SGActionID id = 0; id < actions[state].size(); id++)
+	    setBound(id);
+	}
+    }
 
+  // Upper bound on the level, net of the penalty, of the payoff that
+  // improve would offer for action id.
+  auto upperBound = [&](int state, SGActionID id)
+    {
+      const int a = actions[state][id].getAction();
+      double nonBindingBound = delta*(cache.expectation(pivot,state,a)*currDir);
+      if (doInner)
+	nonBindingBound -= cache.penalty(penalties,tol.subGenFactor,delta,
+					 state,a);
+      return (1-delta)*(payoffs[state][a]*currDir)
+	+ std::max(nonBindingBound,bindingBounds[state][id]);
+    };
+
+  // Computes the non-binding payoff of action id in state, with
+  // its penalty, and the best binding payoff if APSNotBinding is
+  // false. Returns true if the non-binding regime is available for
+  // the action.
+  auto offer = [&](int state, SGActionID id,
+		   SGPoint & nonBindingPayoff, double & nonBindingPenalty,
+		   SGPoint & bestAPSPayoff, bool & APSNotBinding)
+    {
+      const SGAction_MaxMinMax & action = actions[state][id];
+
+      nonBindingPayoff = (1-delta)*payoffs[state]
+	[action.getAction()]
+	+ delta * cache.expectation(pivot,state,action.getAction());
+      nonBindingPenalty = 0.0;
+      if (doInner)
+	nonBindingPenalty = cache.penalty(penalties,tol.subGenFactor,delta,
+					  state,action.getAction());
+	      
+      // Find which payoff is highest in current normal and
+      // break ties in favor of the clockwise 90 degree.
+      int bestBindingPlayer, bestBindingPoint;
+      APSNotBinding=computeBestBindingPayoff(action,bestBindingPlayer,
+					     bestBindingPoint,currDir);
+      if (!APSNotBinding) 
+	bestAPSPayoff =  (1-delta)*payoffs[state][action.getAction()]
+	  + delta * action.getPoints()[bestBindingPlayer][bestBindingPoint];
+
+      return ( APSNotBinding // NB bestAPSPayoff has only been
+	       // set if APSNotBinding ==
+	       // false
+	       || ( !lexComp(nonBindingPayoff,nonBindingPenalty,
+			     bestAPSPayoff,bindingPenalty,
+			     currDir ) ) );
+    };
+
+  // Offers action id as the new policy in state. Returns true if
+  // the non-binding regime is available for the action.
+  auto improve = [&](int state, SGActionID id)
+    {
+      // Procedure to find an improvement to the policy
+      // function
+      SGPoint nonBindingPayoff, bestAPSPayoff;
+      double nonBindingPenalty;
+      bool APSNotBinding;
+      const bool nonBindingAvailable
+	= offer(state,id,nonBindingPayoff,nonBindingPenalty,
+		bestAPSPayoff,APSNotBinding);
+      if (nonBindingAvailable)
+	{
+	  // ok to use non-binding payoff
+	  if (lexComp(nonBindingPayoff,nonBindingPenalty,
+		      newPivot[state],newPenalties[state],
+		      currDir) )
+	    {
+	      bestAPSNotBinding[state] = APSNotBinding;
+	      if (!APSNotBinding)
+		bestBindingPayoffs[state] = bestAPSPayoff;
+		      
+	      newActionTuple[state] = id;
+	      newRegimeTuple[state] = SG::NonBinding;
+	      newPivot[state] = nonBindingPayoff;
+	      newPenalties[state] = nonBindingPenalty;
+
+	      actionsChanged = true;
+	    }
+	}
+      else
+	{
+	  if (lexComp(bestAPSPayoff,bindingPenalty,
+		      newPivot[state],newPenalties[state],
+		      currDir) )
+	    {
+	      bestAPSNotBinding[state] = APSNotBinding;
+	      bestBindingPayoffs[state] = bestAPSPayoff;
+	      newActionTuple[state] = id;
+	      newRegimeTuple[state] = SG::Binding;
+	      newPivot[state] = bestAPSPayoff;
+	      newPenalties[state] = bindingPenalty;
+
+	      actionsChanged = true;
+	    }
+	}
+      return nonBindingAvailable;
+    };
+        
+  // Offers the actions in ids, in order, whose upper bound can pass
+  // lexComp against the incumbent, and stops once no remaining bound
+  // can. The actions are visited in their usual order, since
+  // lexComp's tolerances make the result depend on the order, and
+  // skipped actions would not have changed it. The margin covers
+  // round-off in the bounds.
+  auto scan = [&](int state, const vector<SGActionID> & ids)
+    {
+      bounds.resize(ids.size());
+      remainingBounds.resize(ids.size()+1);
+      remainingBounds.back() = -numeric_limits<double>::max();
+      for (int k = ids.size()-1; k >= 0; k--)
+	{
+	  bounds[k] = upperBound(state,ids[k]);
+	  remainingBounds[k] = std::max(remainingBounds[k+1],bounds[k]);
+	}
+      for (int k = 0; k < ids.size(); k++)
+	{
+	  const double threshold = (newPivot[state]*currDir-newPenalties[state]
+				    -2.0*tol.lexSubOpTol);
+	  if (remainingBounds[k] < threshold)
+	    {
+	      context.stats.policyBoundPruned += ids.size()-k;
+	      break;
+	    }
+	  if (bounds[k] < threshold)
+	    {
+	      context.stats.policyBoundPruned++;
+	      continue;
+	    }
+	  improve(state,ids[k]);
+	}
+    };
+
+  // Anti-cycling rule, used once a policy repeats. Switches only the
+  // first action, in the order of the states and then of the action
+  // IDs, whose payoff is above the level of the current policy by
+  // more than LEXIMPROVETOL. Unlike lexComp, ties are not broken in
+  // the clockwise direction, which is what allows lexComp to cycle.
+  auto switchFirstImprovement = [&]()
+    {
+      SGPoint nonBindingPayoff, bestAPSPayoff;
+      double nonBindingPenalty;
+      bool APSNotBinding;
+      for (int state = 0; state < numStates; state++)
+	{
+	  const double level = newPivot[state]*currDir-newPenalties[state];
+	  auto tryAction = [&](SGActionID id)
+	    {
+	      const bool nonBindingAvailable
+		= offer(state,id,nonBindingPayoff,nonBindingPenalty,
+			bestAPSPayoff,APSNotBinding);
+	      const SGPoint & payoff = (nonBindingAvailable
+					? nonBindingPayoff : bestAPSPayoff);
+	      const double penalty = (nonBindingAvailable
+				      ? nonBindingPenalty : bindingPenalty);
+	      if (payoff*currDir-penalty <= level+tol.lexImproveTol)
+		return false;
+	      bestAPSNotBinding[state] = APSNotBinding;
+	      if (!APSNotBinding)
+		bestBindingPayoffs[state] = bestAPSPayoff;
+	      newActionTuple[state] = id;
+	      newRegimeTuple[state] = (nonBindingAvailable
+				       ? SG::NonBinding : SG::Binding);
+	      newPivot[state] = payoff;
+	      newPenalties[state] = penalty;
+	      actionsChanged = true;
+	      return true;
+	    };
+
+	  if (activeActions)
+	    {
+	      for (SGActionID id : (*activeActions)[state])
+		if (tryAction(id))
+		  return;
+	    }
+	  else
+	    {
+	      for (SGActionID id = 0; id < actions[state].size(); id++)
+		if (tryAction(id))
+		  return;
+	    }
+	} // state
+    };
+
+  // States reached at the end of earlier passes, to detect cycles.
+  // The next pass is determined by the policy and by the incumbents
+  // it starts from, which are not reset between passes, so a
+  // repeated state repeats forever.
+  struct PassState
+  {
+    size_t hash;
+    vector<SGActionID> actionTuple, newActionTuple;
+    vector<SG::Regime> regimeTuple, newRegimeTuple;
+    SGTuple newPivot;
+    vector<double> newPenalties;
+  };
+  vector<PassState> visited;
+  auto stateHash = [&]()
+    {
+      size_t hash = 0;
+      for (int state = 0; state < numStates; state++)
+	{
+	  const size_t v = 4*(4*(static_cast<size_t>(actionTuple[state])
+				 *actions[state].size()
+				 + newActionTuple[state])
+			      + regimeTuple[state]) + newRegimeTuple[state];
+	  hash ^= std::hash<size_t>()(v) + 0x9e3779b97f4a7c15ULL
+	    + (hash << 6) + (hash >> 2);
+	}
+      return hash;
+    };
+  auto sameState = [&](const PassState & s)
+    {
+      if (s.actionTuple != actionTuple || s.newActionTuple != newActionTuple
+	  || s.regimeTuple != regimeTuple
+	  || s.newRegimeTuple != newRegimeTuple
+	  || s.newPenalties != newPenalties)
+	return false;
+      for (int state = 0; state < numStates; state++)
+	{
+	  if (s.newPivot[state] != newPivot[state])
+	    return false;
+	}
+      return true;
+    };
+  bool antiCycling = false;
+
+  context.stats.policyCalls++;
         
   // policy iteration
   do
     {
       // Iterate as long as actions are changing in some state.
+      context.stats.policyPasses++;
       actionsChanged = false;
-      
+      cache.reset();
+
+      if (antiCycling)
+	switchFirstImprovement();
+
       // Look in each state for improvements
-      for (int state = 0; state < numStates; state++)
+      for (int state = 0; state < numStates && !antiCycling; state++)
 	{
-	  for (auto ait = actions[state].begin();
-	       ait != actions[state].end();
-	       ++ait)
+	  if (activeActions)
 	    {
-	      // Procedure to find an improvement to the policy
-	      // function
-	      
-	      SGPoint nonBindingPayoff = (1-delta)*payoffs[state]
-		[ait->getAction()]
-		+ delta * pivot.expectation(probabilities[state][ait->getAction()]);
-	      double nonBindingPenalty = 0.0;
-	      if (doInner)
+	      context.stats.policyActions += (*activeActions)[state].size();
+	      scan(state,(*activeActions)[state]);
+	      continue;
+	    }
+
+	  const SGHullIndex & hull = hulls[state];
+	  context.stats.policyActions += actions[state].size();
+	  candidates.clear();
+	  for (int g = 0; g < hull.size(); g++)
+	    {
+	      // Actions in a group share the expected continuation
+	      // value, so the best non-binding payoff of the group
+	      // comes from the best stage payoff. If it is available,
+	      // it is at least as good as the non-binding payoff of
+	      // every other action in the group, and also as good as
+	      // their binding payoffs, which are only used when they
+	      // are below the action's own non-binding payoff. Actions
+	      // within the tolerance of the best are always checked,
+	      // since lexComp may prefer them.
+	      hull.bestActions(g,currDir,best,nearBest);
+	      bool dominates = false;
+	      for (SGActionID id : best)
 		{
-		  nonBindingPenalty = env.getParam(SG::SUBGENFACTOR);
-		  for (int sp = 0; sp < numStates; sp++)
-		    nonBindingPenalty += delta*probabilities[state][ait->getAction()][sp]*penalties[sp];
+		  SGPoint nonBindingPayoff, bestAPSPayoff;
+		  double nonBindingPenalty;
+		  bool APSNotBinding;
+		  dominates = (offer(state,id,nonBindingPayoff,nonBindingPenalty,
+				     bestAPSPayoff,APSNotBinding)
+			       || dominates);
 		}
-	      
-	      // Find which payoff is highest in current normal and
-	      // break ties in favor of the clockwise 90 degree.
-	      int bestBindingPlayer, bestBindingPoint;
-	      bool APSNotBinding=computeBestBindingPayoff(ait,bestBindingPlayer,
-							  bestBindingPoint,currDir);
-	      SGPoint bestAPSPayoff;
-	      if (!APSNotBinding) 
-		bestAPSPayoff =  (1-delta)*payoffs[state][ait->getAction()]
-		  + delta * ait->getPoints()[bestBindingPlayer][bestBindingPoint];
-	      
-	      if ( APSNotBinding // NB bestAPSPayoff has only been
-		   // set if APSNotBinding ==
-		   // false
-		   || ( !lexComp(nonBindingPayoff,nonBindingPenalty,
-				 bestAPSPayoff,bindingPenalty,
-				 currDir ) ) ) 
+	      if (dominates)
 		{
-		  // ok to use non-binding payoff
-		  if (lexComp(nonBindingPayoff,nonBindingPenalty,
-			      newPivot[state],newPenalties[state],
-			      currDir) )
-		    {
-		      bestAPSNotBinding[state] = APSNotBinding;
-		      if (!APSNotBinding)
-			bestBindingPayoffs[state] = bestAPSPayoff;
-		      
-		      newActionTuple[state] = ait;
-	      	      newRegimeTuple[state] = SG::NonBinding;
-	      	      newPivot[state] = nonBindingPayoff;
-	      	      newPenalties[state] = nonBindingPenalty;
-
-		      actionsChanged = true;
-		    }
+		  candidates.insert(candidates.end(),best.begin(),best.end());
+		  candidates.insert(candidates.end(),
+				    nearBest.begin(),nearBest.end());
+		  context.stats.policyHullPruned += (hull.getActions(g).size()
+						    -best.size()-nearBest.size());
 		}
 	      else
-		{
-		  if (lexComp(bestAPSPayoff,bindingPenalty,
-			      newPivot[state],newPenalties[state],
-			      currDir) )
-		    {
-		      bestAPSNotBinding[state] = APSNotBinding;
-		      bestBindingPayoffs[state] = bestAPSPayoff;
-		      newActionTuple[state] = ait;
-	      	      newRegimeTuple[state] = SG::Binding;
-	      	      newPivot[state] = bestAPSPayoff;
-		      newPenalties[state] = bindingPenalty;
-
-		      actionsChanged = true;
-		    }
-		}
-	    } // ait
+		candidates.insert(candidates.end(),hull.getActions(g).begin(),
+				  hull.getActions(g).end());
+	    } // g
+
+	  // Offer the remaining actions in the order of their IDs, as
+	  // in a scan of all actions, since lexComp's tolerances make
+	  // the result depend on the order.
+	  std::sort(candidates.begin(),candidates.end());
+	  candidates.erase(std::unique(candidates.begin(),candidates.end()),
+			   candidates.end());
+	  scan(state,candidates);
 	} // state
 
-      if (numPolicyIters == env.getParam(SG::MAXPOLICYITERATIONS)/2)
-	cout << "Cycling detected at direction: " << currDir << endl;
-      if (numPolicyIters >= env.getParam(SG::MAXPOLICYITERATIONS)/2)
-	{
-	  cout << "Policy iter: " << numPolicyIters
-	       << ", action tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << actionTuple[state]->getAction() << " ";
-	  cout << "), new action tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << newActionTuple[state]->getAction() << " ";
-	  cout << "), regime tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << regimeTuple[state] << " ";
-	  cout << "), new regime tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << newRegimeTuple[state] << " ";
-	  cout << "), actionsChanged: " << scientific << actionsChanged;
-	  cout << endl;
-	  cout << "\tpivot: "  << pivot
-	       << ", newPivot: " << newPivot;
-	  cout << endl;
-	}
-      
       pivot = newPivot;
       actionTuple = newActionTuple;
       regimeTuple = newRegimeTuple;
@@ -675,27 +1422,61 @@ void SGSolver_MaxMinMax::robustOptimizePolicy(SGTuple & pivot,
 			bestBindingPayoffs,bestAPSNotBinding);
       
       // minimize regimes
-      minimizeRegimes(pivot,penalties,actionTuple,regimeTuple,currDir,
-		      bestBindingPayoffs,bestAPSNotBinding);
+      minimizeRegimes<doInner>(pivot,penalties,actionTuple,regimeTuple,currDir,
+			       bestBindingPayoffs,bestAPSNotBinding,context);
 
-      if (numPolicyIters >= env.getParam(SG::MAXPOLICYITERATIONS)/2)
+      if (actionsChanged)
 	{
-	  cout << "\tpivot: " << pivot;
-	  cout << ", regime tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << regimeTuple[state] << " ";
-	  cout << endl;
+	  const size_t hash = stateHash();
+	  bool repeated = false;
+	  for (int k = 0; k < visited.size() && !repeated; k++)
+	    repeated = (visited[k].hash == hash && sameState(visited[k]));
+	  if (repeated)
+	    {
+	      // A repeat under the anti-cycling rule can only come from
+	      // round-off. Stop at the current policy.
+	      if (antiCycling)
+		break;
+	      context.stats.policyCycles++;
+	      antiCycling = true;
+	    }
+	  visited.push_back({hash,actionTuple,newActionTuple,
+		regimeTuple,newRegimeTuple,newPivot,newPenalties});
 	}
       
     } while (actionsChanged
-	     && ++numPolicyIters < env.getParam(SG::MAXPOLICYITERATIONS));
+	     && ++numPolicyIters < tol.maxPolicyIterations);
+
+  if (antiCycling && !actionsChanged)
+    context.stats.policyCyclesResolved++;
 
-  if (numPolicyIters >= env.getParam(SG::MAXPOLICYITERATIONS))
+  if (numPolicyIters >= tol.maxPolicyIterations)
     cout << "WARNING: Maximum policy iterations reached." << endl;
 
 } // robustOptimizePolicy
 
-void SGSolver_MaxMinMax::updateBestBinding(const vector<SGActionIter> & actionTuple,
+void SGSolver_MaxMinMax::robustOptimizePolicy(SGTuple & pivot,
+					      vector<double> & penalties,
+					      vector<SGActionID> & actionTuple,
+					      vector<SG::Regime> & regimeTuple,
+					      vector<bool> & bestAPSNotBinding,
+					      SGTuple & bestBindingPayoffs,
+					      const SGPoint currDir,
+					      const vector< vector<SGAction_MaxMinMax> > & actions,
+					      const vector< vector<SGActionID> > * activeActions) const
+{
+  SweepContext context = {evaluator,pruningStats};
+  if (tol.doInner())
+    robustOptimizePolicy<true>(pivot,penalties,actionTuple,regimeTuple,
+			       bestAPSNotBinding,bestBindingPayoffs,
+			       currDir,actions,activeActions,context);
+  else
+    robustOptimizePolicy<false>(pivot,penalties,actionTuple,regimeTuple,
+				bestAPSNotBinding,bestBindingPayoffs,
+				currDir,actions,activeActions,context);
+} // robustOptimizePolicy
+
+void SGSolver_MaxMinMax::updateBestBinding(const vector<SGActionID> & actionTuple,
 					   const vector<SG::Regime> & regimeTuple,
 					   const SGPoint & dir,
 					   SGTuple & bestBindingPayoffs,
@@ -706,12 +1487,13 @@ void SGSolver_MaxMinMax::updateBestBinding(const vector<SGActionIter> & actionTu
     {
       if (regimeTuple[state]==SG::Binding)
 	continue;
+      const SGAction_MaxMinMax & action = actions[state][actionTuple[state]];
       int bestBindingPlayer, bestBindingPoint;
-      bestAPSNotBinding[state] = computeBestBindingPayoff(actionTuple[state],
+      bestAPSNotBinding[state] = computeBestBindingPayoff(action,
 							  bestBindingPlayer,
 							  bestBindingPoint,dir);
-      bestBindingPayoffs[state] = (1-delta)*payoffs[state][actionTuple[state]->getAction()]
-	+ delta * actionTuple[state]->getPoints()[bestBindingPlayer][bestBindingPoint];
+      bestBindingPayoffs[state] = (1-delta)*payoffs[state][action.getAction()]
+	+ delta * action.getPoints()[bestBindingPlayer][bestBindingPoint];
     }
 } // updateBestBinding
 
@@ -722,12 +1504,12 @@ bool SGSolver_MaxMinMax::lexComp(const SGPoint & a,
 				 const SGPoint & dir) const
 {
   double diff=a*dir-aPenalty-b*dir+bPenalty;
-  if (diff > env.getParam(SG::LEXIMPROVETOL) )
+  if (diff > tol.lexImproveTol )
     return true;
-  else if ( diff> -1.0*env.getParam(SG::LEXSUBOPTOL) )
+  else if ( diff> -1.0*tol.lexSubOpTol )
     {
       const SGPoint dir2(dir[1],-dir[0]);
-      if (a*dir2-aPenalty-b*dir2+bPenalty > env.getParam(SG::LEXIMPROVETOL) )
+      if (a*dir2-aPenalty-b*dir2+bPenalty > tol.lexImproveTol )
 	return true;
     }
   return false;
@@ -735,18 +1517,18 @@ bool SGSolver_MaxMinMax::lexComp(const SGPoint & a,
 
 bool SGSolver_MaxMinMax::lexAbove(const SGPoint & a, const SGPoint & b) const
 {
-  if ( a*b>env.getParam(SG::LEXIMPROVETOL) )
+  if ( a*b>tol.lexImproveTol )
     return true;
-  else if ( a*b>-1.0*env.getParam(SG::LEXSUBOPTOL) )
+  else if ( a*b>-1.0*tol.lexSubOpTol )
     {
       const SGPoint c(b[1],-b[0]);
-      if (a*c > env.getParam(SG::LEXIMPROVETOL) )
+      if (a*c > tol.lexImproveTol )
 	return true;
     }
   return false;
 } // lexAbove
 
-bool SGSolver_MaxMinMax::computeBestBindingPayoff(const SGActionIter ait,
+bool SGSolver_MaxMinMax::computeBestBindingPayoff(const SGAction_MaxMinMax & action,
 						  int & bestBindingPlayer,
 						  int & bestBindingPoint,
 						  const SGPoint & dir) const
@@ -754,11 +1536,11 @@ bool SGSolver_MaxMinMax::computeBestBindingPayoff(const SGActionIter ait,
   bestBindingPlayer = -1;
   for (int p = 0; p < numPlayers; p++)
     {
-      for (int k = 0; k < ait->getPoints()[p].size(); k++)
+      for (int k = 0; k < action.getPoints()[p].size(); k++)
 	{
 	  if (bestBindingPlayer<0
-	      || lexComp(ait->getPoints()[p][k],0,
-			 ait->getPoints()[bestBindingPlayer][bestBindingPoint],0,
+	      || lexComp(action.getPoints()[p][k],0,
+			 action.getPoints()[bestBindingPlayer][bestBindingPoint],0,
 			 dir) )
 	    {
 	      bestBindingPlayer = p;
@@ -767,7 +1549,7 @@ bool SGSolver_MaxMinMax::computeBestBindingPayoff(const SGActionIter ait,
 	} // point
     } // player
 
-  if (lexAbove(ait->getBndryDirs()[bestBindingPlayer][bestBindingPoint],
+  if (lexAbove(action.getBndryDirs()[bestBindingPlayer][bestBindingPoint],
 	       dir) ) // Can improve on the best
     // binding payoff by moving in
     // along the frontier
@@ -777,43 +1559,261 @@ bool SGSolver_MaxMinMax::computeBestBindingPayoff(const SGActionIter ait,
   return false;
 } // computeBestBindingPayoff
 
+int SGSolver_MaxMinMax::priceActions(const vector<SweepArc> & arcs,
+				     vector<bool> & added)
+{
+  // robustOptimizePolicy offers the non-binding payoff if lexAbove
+  // finds that the binding constraint does not bind, or if lexComp
+  // does not rank it above the best binding payoff, which is then
+  // within lexImproveTol of it. Otherwise it offers the binding
+  // payoff, and the non-binding payoff is within lexSubOpTol of it.
+  // Either way, the payoff offered passes lexComp against the pivot
+  // only if its level is within lexSubOpTol of the pivot's level.
+  // sensitivity cuts an arc with the non-binding payoff under the
+  // same conditions, and with a binding payoff if the non-binding
+  // payoff is within 1e-6 of it. The margins cover round-off.
+  const double margin = 2.0*tol.lexSubOpTol;
+  const double offerTol = tol.lexSubOpTol+margin;
+  const double availableTol = tol.lexImproveTol+offerTol;
+  const double bindingTol = 1e-6+offerTol;
+  const double bindingPenalty = (tol.doInner()? tol.subGenFactor : 0.0);
+
+  // Each arc is priced against the actions that were inactive at
+  // the start of the pass, so that an action added on one arc still
+  // marks the others on which it improves.
+  SGExpectationCache cache(game);
+  vector<bool> isActive, isAdded;
+  added.assign(arcs.size(),false);
+  int numAdded = 0;
+  for (int state = 0; state < numStates; state++)
+    {
+      vector<SGActionID> & active = activeActions[state];
+      const int numActive = active.size();
+      isActive.assign(actions[state].size(),false);
+      for (SGActionID id : active)
+	isActive[id] = true;
+      isAdded.assign(actions[state].size(),false);
+
+      for (int k = 0; k < arcs.size(); k++)
+	{
+	  const SweepArc & arc = arcs[k];
+	  cache.reset();
+
+	  // sensitivity reaches endDir at dir+length*normDir. The levels
+	  // there are affine in length, so a difference that fails a
+	  // test at both ends fails it on the whole arc.
+	  const SGPoint normDir = -1.0*arc.dir.getNormal();
+	  const double length = (arc.endDir*arc.dir > 0
+				 ? (arc.endDir*normDir)/(arc.endDir*arc.dir)
+				 : numeric_limits<double>::infinity());
+	  const double pivotLevel = arc.pivot[state]*arc.dir-arc.penalties[state];
+	  const double pivotSlope = arc.pivot[state]*normDir;
+	  auto maxDiff = [&](const SGPoint & payoff, double penalty)
+	    {
+	      const double diff = payoff*arc.dir-penalty-pivotLevel;
+	      const double slope = payoff*normDir-pivotSlope;
+	      return (slope > 0? diff+length*slope : diff);
+	    };
+
+	  for (SGActionID id = 0; id < actions[state].size(); id++)
+	    {
+	      if (isActive[id])
+		continue;
+	      const SGAction_MaxMinMax & action = actions[state][id];
+	      const int a = action.getAction();
+	      const SGPoint nonBindingPayoff = (1-delta)*payoffs[state][a]
+		+ delta*cache.expectation(arc.pivot,state,a);
+	      double nonBindingPenalty = 0;
+	      if (tol.doInner())
+		nonBindingPenalty = cache.penalty(arc.penalties,tol.subGenFactor,
+						  delta,state,a);
+
+	      const double nonBindingDiff = maxDiff(nonBindingPayoff,
+						    nonBindingPenalty);
+	      if (nonBindingDiff <= -bindingTol)
+		continue;
+	      double bindingDiff = -numeric_limits<double>::max();
+	      for (int p = 0; p < numPlayers; p++)
+		{
+		  const SGTuple & points = action.getPoints()[p];
+		  for (int j = 0; j < points.size(); j++)
+		    bindingDiff = std::max(bindingDiff,
+					   maxDiff((1-delta)*payoffs[state][a]
+						   + delta*points[j],
+						   bindingPenalty));
+		}
+
+	      bool improves = (bindingDiff > -offerTol);
+	      if (!improves && nonBindingDiff > -offerTol)
+		{
+		  improves = (bindingDiff > -availableTol);
+		  for (int p = 0; p < numPlayers && !improves; p++)
+		    {
+		      const SGTuple & bndryDirs = action.getBndryDirs()[p];
+		      for (int j = 0; j < bndryDirs.size() && !improves; j++)
+			{
+			  const double slope = bndryDirs[j]*normDir;
+			  improves = (bndryDirs[j]*arc.dir
+				      + (slope > 0? length*slope : 0.0)
+				      > -offerTol);
+			}
+		    }
+		}
+	      if (improves)
+		{
+		  if (!isAdded[id])
+		    active.push_back(id);
+		  isAdded[id] = true;
+		  added[k] = true;
+		}
+	    } // id
+	} // arc
+
+      numAdded += active.size()-numActive;
+      std::sort(active.begin(),active.end());
+    } // state
+
+  pruningStats.pricingPasses++;
+  pruningStats.actionsActivated += numAdded;
+  return numAdded;
+} // priceActions
+
+double SGSolver_MaxMinMax::maxBindingLevel(const SGAction_MaxMinMax & action,
+					   const SGPoint & dir) const
+{
+  double level = -numeric_limits<double>::max();
+  for (int p = 0; p < numPlayers; p++)
+    {
+      for (int k = 0; k < action.getPoints()[p].size(); k++)
+	level = std::max(level,action.getPoints()[p][k]*dir);
+    }
+  return level;
+} // maxBindingLevel
+
+template<bool doInner>
 void SGSolver_MaxMinMax::minimizeRegimes(SGTuple & pivot,
 					 vector<double> & penalties,
-					 const vector<SGActionIter> & actionTuple,
+					 const vector<SGActionID> & actionTuple,
 					 vector<SG::Regime> & regimeTuple,
 					 const SGPoint & dir,
 					 const SGTuple & bestBindingPayoffs,
-					 const vector<bool> & bestAPSNotBinding) const
+					 const vector<bool> & bestAPSNotBinding,
+					 SweepContext & context) const
 {
+  const double bindingPenalty = (doInner? tol.subGenFactor : 0.0);
+
+  // Predecessors of each state under the actions of the policy, which
+  // do not change here. The states that move to sp with positive
+  // probability are predecessors[predecessorStart[sp]] up to
+  // predecessors[predecessorStart[sp+1]-1]. Only built once a regime
+  // changes, since most calls stop after one round.
+  vector<int> predecessorStart, predecessors;
+  auto buildPredecessors = [&]()
+    {
+      predecessorStart.assign(numStates+1,0);
+      for (int state = 0; state < numStates; state++)
+	game.forEachTransition(state,actions[state][actionTuple[state]].getAction(),
+			       [&](int sp, double prob)
+	  { if (prob > 0) predecessorStart[sp+1]++; });
+      for (int sp = 0; sp < numStates; sp++)
+	predecessorStart[sp+1] += predecessorStart[sp];
+      predecessors.resize(predecessorStart[numStates]);
+      vector<int> next(predecessorStart.begin(),predecessorStart.end()-1);
+      for (int state = 0; state < numStates; state++)
+	game.forEachTransition(state,actions[state][actionTuple[state]].getAction(),
+			       [&](int sp, double prob)
+	  { if (prob > 0) predecessors[next[sp]++] = state; });
+    };
+
   // Minimize regimes, only changes from binding to non-binding
   bool regimesChanged;
   // Keep track of switch to non-binding, which is irreversible.
   vector<bool> switchToNonBinding(numStates,false);
+
+  // The first round evaluates the policy and examines every state.
+  // Afterwards, a regime change in a state only changes the values of
+  // the non-binding states that can reach it, and only those states
+  // and their predecessors can change their regime. The other states
+  // would reach the same decision as in the last round.
+  vector<int> flipped, affected;
+  vector<bool> isAffected(numStates,false), examine(numStates,true);
+  bool firstRound = true;
   
   do
     {
-      policyToPayoffs(pivot,actionTuple,regimeTuple);
-      policyToPenalties(penalties,actionTuple,regimeTuple);
+      setEvaluatorPolicy(context.evaluator,actionTuple,regimeTuple);
+      if (firstRound)
+	{
+	  context.evaluator.payoffs(pivot);
+	  // Penalties are identically zero for the outer approximation
+	  if (doInner)
+	    context.evaluator.penalties(penalties,tol.subGenFactor);
+	  firstRound = false;
+	}
+      else
+	{
+	  // Search backwards from the flipped states through the
+	  // non-binding states, whose values depend on their
+	  // successors.
+	  if (predecessorStart.empty())
+	    buildPredecessors();
+	  affected = flipped;
+	  for (int state : flipped)
+	    isAffected[state] = true;
+	  for (int k = 0; k < affected.size(); k++)
+	    {
+	      const int sp = affected[k];
+	      for (int j = predecessorStart[sp]; j < predecessorStart[sp+1]; j++)
+		{
+		  const int state = predecessors[j];
+		  examine[state] = true;
+		  if (!isAffected[state] && regimeTuple[state] == SG::NonBinding)
+		    {
+		      isAffected[state] = true;
+		      affected.push_back(state);
+		    }
+		}
+	    }
+	  for (int state : affected)
+	    {
+	      isAffected[state] = false;
+	      examine[state] = true;
+	    }
+
+	  context.evaluator.payoffs(pivot,affected);
+	  if (doInner)
+	    context.evaluator.penalties(penalties,tol.subGenFactor,affected);
+	}
 
       regimesChanged = false;
+      flipped.clear();
       for (int state = 0; state < numStates; state++)
 	{
+	  if (!examine[state])
+	    continue;
+	  examine[state] = false;
+
 	  if (bestAPSNotBinding[state])
 	    {
 	      if (regimeTuple[state] == SG::Binding)
 		{
 		  regimeTuple[state] = SG::NonBinding;
 		  regimesChanged = true;
+		  flipped.push_back(state);
 		}
 	      continue;
 	    }
 	  
-	  SGPoint nonBindingPayoff = (1-delta)*payoffs[state]
-	    [actionTuple[state]->getAction()]
-	    + delta * pivot.expectation(probabilities[state][actionTuple[state]->getAction()]);
-	  double nonBindingPenalty = env.getParam(SG::SUBGENFACTOR);
-	  for (int sp = 0; sp < numStates; sp++)
-	    nonBindingPenalty += delta*probabilities[state][actionTuple[state]->getAction()][sp]*penalties[sp];
+	  const int action = actions[state][actionTuple[state]].getAction();
+	  SGPoint nonBindingPayoff = (1-delta)*payoffs[state][action]
+	    + delta * game.expectation(pivot,state,action);
+	  double nonBindingPenalty = 0.0;
+	  if (doInner)
+	    {
+	      nonBindingPenalty = tol.subGenFactor;
+	      game.forEachTransition(state,action,[&](int sp, double prob)
+		{ nonBindingPenalty += delta*prob*penalties[sp]; });
+	    }
 	  
 	  if (regimeTuple[state] == SG::Binding
 	      && lexComp(pivot[state],penalties[state],
@@ -823,16 +1823,27 @@ void SGSolver_MaxMinMax::minimizeRegimes(SGTuple & pivot,
 	      switchToNonBinding[state] = true; 
 	      regimeTuple[state] = SG::NonBinding;
 	      regimesChanged=true;
+	      flipped.push_back(state);
 	    }
 	  else if (!switchToNonBinding[state]
 		   && regimeTuple[state] == SG::NonBinding
 		   && lexComp(pivot[state],penalties[state],
-			      bestBindingPayoffs[state],env.getParam(SG::SUBGENFACTOR),
+			      bestBindingPayoffs[state],bindingPenalty,
 			      dir))
 	    {
 	      regimesChanged = true;
 	      regimeTuple[state] = SG::Binding;
 	      pivot[state] = bestBindingPayoffs[state];
+	      flipped.push_back(state);
+
+	      // Later predecessors see the new payoff in this round.
+	      if (predecessorStart.empty())
+		buildPredecessors();
+	      for (int j = predecessorStart[state]; j < predecessorStart[state+1]; j++)
+		{
+		  if (predecessors[j] > state)
+		    examine[predecessors[j]] = true;
+		}
 	    }
 	}
 
@@ -840,12 +1851,32 @@ void SGSolver_MaxMinMax::minimizeRegimes(SGTuple & pivot,
 
 } // minimizeRegimes
 
+void SGSolver_MaxMinMax::minimizeRegimes(SGTuple & pivot,
+					 vector<double> & penalties,
+					 const vector<SGActionID> & actionTuple,
+					 vector<SG::Regime> & regimeTuple,
+					 const SGPoint & dir,
+					 const SGTuple & bestBindingPayoffs,
+					 const vector<bool> & bestAPSNotBinding) const
+{
+  SweepContext context = {evaluator,pruningStats};
+  if (tol.doInner())
+    minimizeRegimes<true>(pivot,penalties,actionTuple,regimeTuple,dir,
+			  bestBindingPayoffs,bestAPSNotBinding,context);
+  else
+    minimizeRegimes<false>(pivot,penalties,actionTuple,regimeTuple,dir,
+			   bestBindingPayoffs,bestAPSNotBinding,context);
+} // minimizeRegimes
+
+template<bool doInner>
 double SGSolver_MaxMinMax::sensitivity(const SGTuple & pivot,
 				       const vector<double> & penalties,
-				       const vector<SGActionIter> & actionTuple,
+				       const vector<SGActionID> & actionTuple,
 				       const vector<SG::Regime> & regimeTuple,
 				       const SGPoint currDir,
-				       const vector<list<SGAction_MaxMinMax> > & actions) const
+				       const vector< vector<SGAction_MaxMinMax> > & actions,
+				       const vector< vector<SGActionID> > * activeActions,
+				       SweepContext & context) const
 {
   SGPoint normDir = -1.0*currDir.getNormal(); // Rotate the direction clockwise by pi/2 radians
   
@@ -854,190 +1885,230 @@ double SGSolver_MaxMinMax::sensitivity(const SGTuple & pivot,
   double bindingIndiffLvl = -1;
   double bestLevel = numeric_limits<double>::max()-1.0;
   
-  bool doInner = env.getParam(SG::SUBGENFACTOR)>0;
-  double bindingPenalty = 0;
-  if (doInner)
-    bindingPenalty = env.getParam(SG::SUBGENFACTOR);
+  const double bindingPenalty = (doInner? tol.subGenFactor : 0.0);
 
   int bestBindingPlayer,bestBindingPoint;
+
+  SGExpectationCache cache(game);
   
-  // Look in each state for improvements
-  for (int state = 0; state < numStates; state++)
+  // Lower bound on the indifference levels of the payoffs of action
+  // id. Every payoff c of the action is at most (U,V) in the
+  // directions (currDir,normDir), net of its penalty in currDir, so
+  // its level (pivot-c)*currDir/(normDir*(c-pivot)) is at least
+  // (pivot*currDir-U)/(V-pivot*normDir) when both are positive. The
+  // margin covers round-off.
+  auto lowerBound = [&](int state, SGActionID id)
     {
-
-      for (auto ait = actions[state].begin();
-	   ait != actions[state].end();
-	   ++ait)
+      const SGAction_MaxMinMax & action = actions[state][id];
+      const int a = action.getAction();
+      const SGPoint expPivot = cache.expectation(pivot,state,a);
+      double nonBindingLevel = delta*(expPivot*currDir);
+      if (doInner)
+	nonBindingLevel -= cache.penalty(penalties,tol.subGenFactor,delta,
+					 state,a);
+      const double maxLevel = (1-delta)*(payoffs[state][a]*currDir)
+	+ std::max(nonBindingLevel,
+		   delta*maxBindingLevel(action,currDir)-bindingPenalty);
+      const double maxNormLevel = (1-delta)*(payoffs[state][a]*normDir)
+	+ delta*std::max(expPivot*normDir,maxBindingLevel(action,normDir));
+
+      const double numer = pivot[state]*currDir-penalties[state]
+	-maxLevel-tol.lexSubOpTol;
+      const double denom = maxNormLevel-pivot[state]*normDir+tol.lexSubOpTol;
+      if (denom <= 0)
+	return numeric_limits<double>::max();
+      if (numer < 0)
+	return -numeric_limits<double>::max();
+      return numer/denom;
+    };
+
+  // Updates bestLevel with the payoffs of action id
+  auto check = [&](int state, SGActionID id)
+    {
+      const SGAction_MaxMinMax & action = actions[state][id];
+
+      // Find the smallest weight on normDir such that this action
+      // improves in that direction. For each of the binding 
+
+      SGPoint nonBindingPayoff = (1-delta)*payoffs[state]
+	[action.getAction()]
+	+ delta * cache.expectation(pivot,state,action.getAction());
+      double nonBindingPenalty = 0.0;
+      if (doInner)
+	nonBindingPenalty = cache.penalty(penalties,tol.subGenFactor,delta,
+					  state,action.getAction());
+
+      // Calculate the lvl at which indifferent to the pivot
+      // pivot[state]*(currDir+tmp*normDir)-penalties[state]<=nonBindingPayoff*(currDir+tmp*normDir)-nonBindingPenalty;
+      // (pivot[state]-nonBindingPayoff)*currDir-(penalties[state]-nonBindingPenalty))<=-tmp*normDir*(pivot[state]-nonBindingPayoff)
+      double denom = normDir*(nonBindingPayoff-pivot[state]);
+      double numer = (pivot[state]-nonBindingPayoff)*currDir;
+      if (doInner)
+	numer -= penalties[state]-nonBindingPenalty;
+      if (SGPoint::distance(pivot[state],nonBindingPayoff) > 1e-10
+	  && abs(denom) > 1e-10)
 	{
-	  // Find the smallest weight on normDir such that this action
-	  // improves in that direction. For each of the binding 
+	  nonBindingIndiffLvl = numer/denom;
 
-	  SGPoint nonBindingPayoff = (1-delta)*payoffs[state]
-	    [ait->getAction()]
-	    + delta * pivot.expectation(probabilities[state][ait->getAction()]);
-	  double nonBindingPenalty = 0.0;
-	  if (doInner)
+	  if (nonBindingIndiffLvl < bestLevel
+	      && nonBindingIndiffLvl > 1e-12)
 	    {
-	      nonBindingPenalty = env.getParam(SG::SUBGENFACTOR);
-	      for (int sp = 0; sp < numStates; sp++)
-		nonBindingPenalty += delta*probabilities[state][ait->getAction()][sp]*penalties[sp];
-	    }
-
-	  // Calculate the lvl at which indifferent to the pivot
-	  // pivot[state]*(currDir+tmp*normDir)-penalties[state]<=nonBindingPayoff*(currDir+tmp*normDir)-nonBindingPenalty;
-	  // (pivot[state]-nonBindingPayoff)*currDir-(penalties[state]-nonBindingPenalty))<=-tmp*normDir*(pivot[state]-nonBindingPayoff)
-	  double denom = normDir*(nonBindingPayoff-pivot[state]);
-	  double numer = (pivot[state]-nonBindingPayoff)*currDir
-	    -(penalties[state]-nonBindingPenalty);
-	  if (SGPoint::distance(pivot[state],nonBindingPayoff) > 1e-10
-	      && abs(denom) > 1e-10)
-	    {
-	      nonBindingIndiffLvl = numer/denom;
-
-	      if (nonBindingIndiffLvl < bestLevel
-		  && nonBindingIndiffLvl > 1e-12)
+	      SGPoint indiffDir = currDir + normDir * nonBindingIndiffLvl;
+
+	      // See if a binding payoff is higher in the
+	      // indifference direction
+	      double bestBindLvl = -numeric_limits<double>::max();
+	      bool bestAPSNotBinding=computeBestBindingPayoff(action,bestBindingPlayer,
+							      bestBindingPoint,indiffDir);
+	      SGPoint bestAPSPayoff =  (1-delta)*payoffs[state][action.getAction()]
+		+ delta * action.getPoints()[bestBindingPlayer][bestBindingPoint];
+
+
+	      if ( bestAPSNotBinding // NB bestAPSPayoff has only been
+		   // set if bestAPSNotBinding ==
+		   // true
+		   || lexComp(bestAPSPayoff,bindingPenalty,
+			      nonBindingPayoff,nonBindingPenalty,
+			      indiffDir) ) 
 		{
-		  SGPoint indiffDir = currDir + normDir * nonBindingIndiffLvl;
-
-		  // See if a binding payoff is higher in the
-		  // indifference direction
-		  double bestBindLvl = -numeric_limits<double>::max();
-		  bool bestAPSNotBinding=computeBestBindingPayoff(ait,bestBindingPlayer,
-								  bestBindingPoint,indiffDir);
-		  SGPoint bestAPSPayoff =  (1-delta)*payoffs[state][ait->getAction()]
-		    + delta * ait->getPoints()[bestBindingPlayer][bestBindingPoint];
-
-
-		  if ( bestAPSNotBinding // NB bestAPSPayoff has only been
-		       // set if bestAPSNotBinding ==
-		       // true
-		       || lexComp(bestAPSPayoff,bindingPenalty,
-				  nonBindingPayoff,nonBindingPenalty,
-				  indiffDir) ) 
-		    {
-		      // If we get to here, non-binding regime is
-		      // available in the indifferent direction, and
-		      // this direction is smaller than the best level
-		      // found so far.
-
-		      if ( (ait != actionTuple[state] && denom> 1e-10)
-			   || (ait == actionTuple[state]
-			       && denom < -1e-10
-			       && regimeTuple[state] == SG::Binding) )
-			bestLevel = nonBindingIndiffLvl;
-		    }
-		} // Non-binding indifference level is smaller than best level
-	    } // Positive level of indifference
+		  // If we get to here, non-binding regime is
+		  // available in the indifferent direction, and
+		  // this direction is smaller than the best level
+		  // found so far.
+
+		  if ( (id != actionTuple[state] && denom> 1e-10)
+		       || (id == actionTuple[state]
+			   && denom < -1e-10
+			   && regimeTuple[state] == SG::Binding) )
+		    bestLevel = nonBindingIndiffLvl;
+		}
+	    } // Non-binding indifference level is smaller than best level
+	} // Positive level of indifference
 
 
-	      // Now check the binding directions
-	  for (int p = 0; p < numPlayers; p++)
+	  // Now check the binding directions
+      for (int p = 0; p < numPlayers; p++)
+	{
+	  for (int k = 0; k < action.getPoints()[p].size(); k++)
 	    {
-	      for (int k = 0; k < ait->getPoints()[p].size(); k++)
+	      SGPoint bindingPayoff = (1-delta)*payoffs[state]
+		[action.getAction()]
+		+ delta * action.getPoints()[p][k];
+	      double denom = normDir*(bindingPayoff-pivot[state]);
+	      double numer = (pivot[state]-bindingPayoff)*currDir;
+	      if (doInner)
+		numer -= penalties[state]-bindingPenalty;
+	      if (SGPoint::distance(pivot[state],bindingPayoff)>1e-6
+		  && abs(denom) > 1e-10)
 		{
-		  SGPoint bindingPayoff = (1-delta)*payoffs[state]
-		    [ait->getAction()]
-		    + delta * ait->getPoints()[p][k];
-		  double denom = normDir*(bindingPayoff-pivot[state]);
-		  double numer = (pivot[state]-bindingPayoff)*currDir
-		    - (penalties[state]-bindingPenalty);
-		  if (SGPoint::distance(pivot[state],bindingPayoff)>1e-6
-		      && abs(denom) > 1e-10)
+		  bindingIndiffLvl = numer/denom;
+
+		  if (bindingIndiffLvl < bestLevel
+		      && bindingIndiffLvl > 1e-12)
 		    {
-		      bindingIndiffLvl = numer/denom;
+		      SGPoint indiffDir = currDir + normDir * bindingIndiffLvl;
 
-		      if (bindingIndiffLvl < bestLevel
-			  && bindingIndiffLvl > 1e-12)
+		      if (nonBindingPayoff*indiffDir-nonBindingPenalty
+			  >= bindingPayoff*indiffDir-bindingPenalty-1e-6)
 			{
-			  SGPoint indiffDir = currDir + normDir * bindingIndiffLvl;
-
-			  if (nonBindingPayoff*indiffDir-nonBindingPenalty
-			      >= bindingPayoff*indiffDir-bindingPenalty-1e-6)
-			    {
-			      if ( (ait != actionTuple[state]
-				    && denom > 1e-6 )
-				   || (ait == actionTuple[state]
-				       && (regimeTuple[state]==SG::NonBinding
-					   && denom < -1e-6 )
-				       || (regimeTuple[state]==SG::Binding
-					   && denom > 1e-6) ) )
-				bestLevel = bindingIndiffLvl;
-			    } // Binding payoff is available
-			} // Smaller than the current bestLvl
-		    } // Denominator is positive
-		} // point
-	    } // player
-	} // ait
-
+			  if ( (id != actionTuple[state]
+				&& denom > 1e-6 )
+			       || (id == actionTuple[state]
+				   && (regimeTuple[state]==SG::NonBinding
+				       && denom < -1e-6 )
+				   || (regimeTuple[state]==SG::Binding
+				       && denom > 1e-6) ) )
+			    bestLevel = bindingIndiffLvl;
+			} // Binding payoff is available
+		    } // Smaller than the current bestLvl
+		} // Denominator is positive
+	    } // point
+	} // player
+    };
+
+  vector< pair<double,SGActionID> > candidates;
+  
+  // Look in each state for improvements
+  for (int state = 0; state < numStates; state++)
+    {
+      const int numCandidates = (activeActions
+				 ? (*activeActions)[state].size()
+				 : actions[state].size());
+      context.stats.sensitivityActions += numCandidates;
+
+      // The bound assumes a positive denominator, which is not
+      // required for the current action, so it is always checked.
+      check(state,actionTuple[state]);
+
+      // Check the others in increasing order of their lower bounds,
+      // and stop once the bound reaches bestLevel.
+      candidates.clear();
+      for (int k = 0; k < numCandidates; k++)
+	{
+	  const SGActionID id = (activeActions? (*activeActions)[state][k] : k);
+	  if (id != actionTuple[state])
+	    candidates.push_back(pair<double,SGActionID>(lowerBound(state,id),id));
+	}
+      std::sort(candidates.begin(),candidates.end());
+      for (int k = 0; k < candidates.size(); k++)
+	{
+	  if (candidates[k].first >= bestLevel)
+	    {
+	      context.stats.sensitivityBoundPruned += candidates.size()-k;
+	      break;
+	    }
+	  check(state,candidates[k].second);
+	}
     } // state
 
   return std::max(bestLevel,0.0);
 
 } // sensitivity
 
+double SGSolver_MaxMinMax::sensitivity(const SGTuple & pivot,
+				       const vector<double> & penalties,
+				       const vector<SGActionID> & actionTuple,
+				       const vector<SG::Regime> & regimeTuple,
+				       const SGPoint currDir,
+				       const vector< vector<SGAction_MaxMinMax> > & actions,
+				       const vector< vector<SGActionID> > * activeActions) const
+{
+  SweepContext context = {evaluator,pruningStats};
+  if (tol.doInner())
+    return sensitivity<true>(pivot,penalties,actionTuple,regimeTuple,
+			     currDir,actions,activeActions,context);
+  return sensitivity<false>(pivot,penalties,actionTuple,regimeTuple,
+			    currDir,actions,activeActions,context);
+} // sensitivity
+
+
+void SGSolver_MaxMinMax::setEvaluatorPolicy(SGPolicyEvaluator & evaluator,
+					    const vector<SGActionID>  & actionTuple,
+					    const vector<SG::Regime> & regimeTuple)
+  const
+{
+  vector<int> actionIndices(numStates);
+  for (int state = 0; state < numStates; state++)
+    actionIndices[state] = actions[state][actionTuple[state]].getAction();
+  evaluator.setPolicy(actionIndices,regimeTuple);
+} // setEvaluatorPolicy
 
 void SGSolver_MaxMinMax::policyToPayoffs(SGTuple & pivot,
-					 const vector<SGActionIter>  & actionTuple,
+					 const vector<SGActionID>  & actionTuple,
 					 const vector<SG::Regime> & regimeTuple)
   const
 {
-  // Do Bellman iteration to find new fixed point
-  int updatePasses = 0;
-  double bellmanGap = 0;
-  SGTuple newPivot(pivot);
-
-  do
-    {
-      for (int state = 0; state < numStates; state++)
-	{
-	  if (regimeTuple[state] == SG::NonBinding)
-	    newPivot[state] = (1-delta)*payoffs[state]
-	      [actionTuple[state]->getAction()]
-	      + delta*pivot.expectation(probabilities[state]
-					[actionTuple[state]->getAction()]);
-	}
-      bellmanGap = SGTuple::distance(newPivot,pivot);
-      pivot = newPivot;
-    } while (bellmanGap > env.getParam(SG::UPDATEPIVOTTOL)
-	     && (++updatePasses < env.getParam(SG::MAXUPDATEPIVOTPASSES) ));
-
-  if (updatePasses == env.getParam(SG::MAXUPDATEPIVOTPASSES) )
-    cout << "WARNING: Maximum pivot update passes reached." << endl;
-  
+  setEvaluatorPolicy(evaluator,actionTuple,regimeTuple);
+  evaluator.payoffs(pivot);
 } // policyToPayoffs
 
 void SGSolver_MaxMinMax::policyToPenalties(vector<double> & penalties,
-					   const vector<SGActionIter>  & actionTuple,
+					   const vector<SGActionID>  & actionTuple,
 					   const vector<SG::Regime> & regimeTuple)
   const
 {
-  // Do Bellman iteration to find new fixed point
   assert(penalties.size()==numStates);
-  
-  int updatePasses = 0;
-  double bellmanGap = 0;
 
-  do
-    {
-      bellmanGap = 0.0;
-
-      vector<double> newPenalties(numStates,env.getParam(SG::SUBGENFACTOR));
-      for (int state = 0; state < numStates; state++)
-	{
-	  if (regimeTuple[state] == SG::NonBinding)
-	    {
-	      for (int sp = 0; sp < numStates; sp++)
-		newPenalties[state] += delta*probabilities[state]
-		  [actionTuple[state]->getAction()][sp]*penalties[sp];
-
-	    }
-	  bellmanGap = max(bellmanGap,abs(newPenalties[state]-penalties[state]));
-	}
-      penalties = newPenalties;
-    } while (bellmanGap > env.getParam(SG::UPDATEPIVOTTOL)
-	     && (++updatePasses < env.getParam(SG::MAXUPDATEPIVOTPASSES) ));
-
-  if (updatePasses == env.getParam(SG::MAXUPDATEPIVOTPASSES) )
-    cout << "WARNING: Maximum pivot update passes reached." << endl;
-  
+  setEvaluatorPolicy(evaluator,actionTuple,regimeTuple);
+  evaluator.penalties(penalties,tol.subGenFactor);
 } // policyToPenalties
@@ -26,6 +26,7 @@
 SGSolver_MaxMinMax_3Player::SGSolver_MaxMinMax_3Player(const SGEnv & _env,
 						       const SGGame & _game):
   env(_env),
+  tol(_env),
   game(_game),
   soln(_game),
   numPlayers(_game.getNumPlayers()),
@@ -33,10 +34,11 @@ SGSolver_MaxMinMax_3Player::SGSolver_MaxMinMax_3Player(const SGEnv & _env,
   delta(_game.getDelta()),
   payoffs(_game.getPayoffs()),
   eqActions(_game.getEquilibriumActions()),
-  probabilities(_game.getProbabilities()),
   numActions(_game.getNumActions()),
   numActions_totalByState(_game.getNumActions_total()),
-  debugMode(false)
+  maxMeshDepth(0),
+  debugMode(false),
+  evaluator(_game)
 {
   
 }
@@ -51,35 +53,68 @@ void SGSolver_MaxMinMax_3Player::solve(const int numDirsApprox,
   
   // Initialize directions
   int numDirections = 0;
+  dirVertices.clear();
 
-  double a = 4.0*PI/static_cast<double>(numDirsApprox);
-  double d = sqrt(a);
-  int Mpsi = round(PI/d);
-  double dpsi = PI/static_cast<double>(Mpsi);
-  double dphi = a/dpsi;
-
-  // Initialize directions - approximately evenly spaced around the
-  // sphere, with three negative coordinate directions at the end.
-  vector< list<vector< double> > :: const_iterator> playerMinLvls(numPlayers);
-  for (int mpsi = 0; mpsi < Mpsi; mpsi++)
+  if (tol.adaptiveDirections)
     {
-      double psi = PI*(static_cast<double>(mpsi)+0.5)/static_cast<double>(Mpsi);
-      int Mphi = round(2.0*PI*sin(psi)/dpsi);
+      // Refine the icosahedron uniformly as long as that leaves at
+      // least three quarters of the directions for adaptive
+      // refinement. Each uniform refinement takes V vertices to
+      // 4V-6.
+      mesh = SGGeodesicMesh();
+      vector<int> added;
+      int numVertices = 12;
+      while (4*(4*numVertices-6) <= numDirsApprox)
+	{
+	  mesh.refineAll(added);
+	  numVertices = 4*numVertices-6;
+	}
 
-      for (int mphi = 0; mphi < Mphi; mphi++)
+      // Refine at most as deep as the first uniform refinement with
+      // numDirsApprox directions.
+      maxMeshDepth = 0;
+      for (int n = 12; n < numDirsApprox; n = 4*n-6)
+	maxMeshDepth++;
+      for (int v = 0; v < mesh.numVertices(); v++)
+	{
+	  if (!mesh.isActive(v))
+	    continue;
+	  levels.push_back(mesh.getVertex(v),vector<double>(numStates,0));
+	  dirVertices.push_back(v);
+	}
+      // The rest of the directions are added by refineDirections.
+      numDirections = std::max(numDirsApprox,levels.size());
+    }
+  else
+    {
+      double a = 4.0*PI/static_cast<double>(numDirsApprox);
+      double d = sqrt(a);
+      int Mpsi = round(PI/d);
+      double dpsi = PI/static_cast<double>(Mpsi);
+      double dphi = a/dpsi;
+
+      // Initialize directions - approximately evenly spaced around the
+      // sphere, with three negative coordinate directions at the end.
+      for (int mpsi = 0; mpsi < Mpsi; mpsi++)
 	{
-	  double phi = 2.0*PI*static_cast<double>(mphi)/static_cast<double>(Mphi);
+	  double psi = PI*(static_cast<double>(mpsi)+0.5)/static_cast<double>(Mpsi);
+	  int Mphi = round(2.0*PI*sin(psi)/dpsi);
 
-	  SGPoint newDir(numPlayers,0.0);
-	  newDir[0]=sin(psi)*cos(phi);
-	  newDir[1]=sin(psi)*sin(phi);
-	  newDir[2]=cos(psi);
-	  directions.push_back(newDir);
-	  levels.push_back(vector<double>(numStates,0));
+	  for (int mphi = 0; mphi < Mphi; mphi++)
+	    {
+	      double phi = 2.0*PI*static_cast<double>(mphi)/static_cast<double>(Mphi);
+
+	      SGPoint newDir(numPlayers,0.0);
+	      newDir[0]=sin(psi)*cos(phi);
+	      newDir[1]=sin(psi)*sin(phi);
+	      newDir[2]=cos(psi);
+	      levels.push_back(newDir,vector<double>(numStates,0));
+	      dirVertices.push_back(-1);
 
-	  numDirections++;	  
+	      numDirections++;        
+	    }
 	}
-    }
+    } // uniform directions
 
   threatDirections.clear();
   for (int player = 0; player <numPlayers; player++)
@@ -95,10 +130,11 @@ void SGSolver_MaxMinMax_3Player::solve(const int numDirsApprox,
 
   numRedundDirs = 0;
   numEndogDirs = 0;
+  numRefinedDirs = 0;
   
-  while (errorLevel > env.getParam(SG::ERRORTOL))
+  while (errorLevel > tol.errorTol)
     {
-      if(numIter >= env.getParam(SG::MAXITERATIONS))
+      if(numIter >= tol.maxIterations)
 	throw(SGException(SG::MAX_ITERATIONS_REACHED));
       else 
       {
@@ -114,6 +150,9 @@ void SGSolver_MaxMinMax_3Player::solve(const int numDirsApprox,
   cout << "Overall added " << numEndogDirs
        << " endogenous directions and removed " << numRedundDirs
        << " redundant directions." << endl;
+  if (tol.adaptiveDirections)
+    cout << "Added " << numRefinedDirs
+	 << " directions by refinement." << endl;
 
 } // solve
 
@@ -127,92 +166,145 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
   unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
   std::default_random_engine generator (seed);
   std::normal_distribution<double> normDistr(0.0,1.0);
-  std::uniform_int_distribution<int> intDistr(0.0,directions.size());
+  std::uniform_int_distribution<int> intDistr(0.0,levels.size());
 
   SGTuple pivot = threatTuple;
 
   SGIteration_MaxMinMax iter;
 
-  vector<SGActionIter> actionTuple(numStates);
+  assert(dirVertices.size() == levels.size());
+
   // Pick the initial actions arbitrarily
-  for (int state = 0; state < numStates; state++)
-    actionTuple[state] = actions[state].begin();
+  vector<SGActionID> actionTuple(numStates,0);
       
   vector<SG::Regime> regimeTuple(numStates,SG::Binding);
 
-  // Reset the trimmed points for the actions
+  // Reset the trimmed points for the actions and remove the ones
+  // that can no longer be supported
   for (int state = 0; state < numStates; state++)
     {
-      for (auto ait = actions[state].begin();
-	   ait != actions[state].end();
-	   ++ait)
-	{
-	  ait->updateTrim();
-	      
-	  if (!(ait->supportable()))
-	    {
-	      actions[state].erase(ait++);
-	      continue;
-	    }
-	      
-	} // for ait
+      for (auto & action : actions[state])
+	action.updateTrim();
+      eraseUnsupportable(actions[state]);
     } // for state
 
-  if (env.getParam(SG::STOREITERATIONS))
+  if (tol.storeIterations)
     iter = SGIteration_MaxMinMax(actions,threatTuple);
       
   // Reset the error level
   errorLevel = 0;
 
   {
-    list<vector< double> >::iterator lvl;
-    int dirCnt;
-    list<SGPoint>::const_iterator dir;
-
-    // Iterate through directions
-    for (dir = directions.cbegin(),
-	   lvl = levels.begin(),
-	   dirCnt = 0;
-	 dir != directions.cend(),
-	   lvl != levels.end();
-	 dir++, lvl++, dirCnt ++ )
+    // Iterate through directions, in blocks with their own evaluators
+    // that are optimized in parallel.
+    const int numDirs = levels.size();
+    const int blockSize = 8;
+    const int numBlocks = (numDirs+blockSize-1)/blockSize;
+    policies.resize(numDirs);
+    vector<SGPolicyEvaluator> evaluators(numBlocks,evaluator);
+    vector< vector<SGActionID> > dirActions(numDirs);
+    vector<double> dirErrors(numDirs,0);
+    vector<int> blockCapped(numBlocks,0);
+
+    threadPool->parallelFor(numBlocks,[&](int block)
       {
-	// Compute optimal level in this direction
-	vector<double> newLevels(numStates,0);
-	SGPoint currDir = *dir;
+	SGTuple blockPivot = threatTuple;
+	vector<SGActionID> blockActions(numStates,0);
+	vector<SG::Regime> blockRegimes(numStates,SG::Binding);
+
+	for (int dir = block*blockSize;
+	     dir < std::min(numDirs,(block+1)*blockSize); dir++)
+	  {
+	    // Start from the policy of this direction in the last
+	    // iteration, if there is one.
+	    DirectionPolicy & policy = policies[dir];
+	    loadPolicy(blockPivot,blockActions,blockRegimes,policy);
 
-	optimizePolicy(pivot,actionTuple,regimeTuple,currDir,actions);
-	for (int s = 0; s < numStates; s++)
-	  assert(pivot[s].size()==numPlayers);
+	    // Compute optimal level in this direction
+	    const SGPoint currDir = levels.getDirection(dir);
+	    if (!optimizePolicy(blockPivot,blockActions,blockRegimes,currDir,
+				actions,evaluators[block]))
+	      blockCapped[block]++;
 
-	// SGProductPolicy optPolicies(numStates);
-	// computeOptimalPolicies(optPolicies,pivot,currDir,actions);
+	    for (int state = 0; state < numStates; state++)
+	      {
+		// Update the levels and the error level with the
+		// movement in this direction
+		const double newLevel = blockPivot[state]*currDir;
+		dirErrors[dir] = max(dirErrors[dir],
+				     abs(newLevel-levels.level(dir,state)));
+		levels.level(dir,state) = newLevel;
+	      } // for state
+
+	    policy = recordPolicy(blockPivot,blockActions,blockRegimes);
+	    dirActions[dir] = blockActions;
+	  } // for dir
+      });
+
+    // Report policy iteration caps here rather than from the worker
+    // threads, so the output does not interleave.
+    int numCapped = 0;
+    for (int block = 0; block < numBlocks; block++)
+      numCapped += blockCapped[block];
+    if (numCapped > 0)
+      cout << "WARNING: Maximum policy iterations reached in "
+	   << numCapped << " directions." << endl;
+
+    for (int dir = 0; dir < numDirs; dir++)
+      {
+	errorLevel = max(errorLevel,dirErrors[dir]);
 
-	for (int state = 0; state < numStates; state++)
+	if (tol.storeIterations)
 	  {
-	    // Update the levels and the error level with the
-	    // movement in this direction
-	    newLevels[state] = pivot[state]*currDir;
-	    errorLevel = max(errorLevel,abs(newLevels[state]-(*lvl)[state]));
-	    (*lvl)[state] = newLevels[state];
-	  } // for state
-
-	if (env.getParam(SG::STOREITERATIONS))
-	  iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
-				SGHyperplane(currDir,newLevels),actions));
-	    
-      } // for dir lvl dirCntr
+	    vector<double> newLevels(numStates,0);
+	    for (int state = 0; state < numStates; state++)
+	      newLevels[state] = levels.level(dir,state);
+	    iter.push_back(SGStep(dirActions[dir],policies[dir].regimes,
+				  policies[dir].pivot,
+				  SGHyperplane(levels.getDirection(dir),newLevels)));
+	  }
+      } // for dir
+
+    // The remaining directions start from the last one.
+    if (numDirs > 0)
+      {
+	pivot = policies[numDirs-1].pivot;
+	actionTuple = dirActions[numDirs-1];
+	regimeTuple = policies[numDirs-1].regimes;
+      }
   } // Computing new levels
 
-  // If there are fewer directions than the max, add a new face
+  // If there are fewer directions than the max, refine the mesh
+  // where the optimal policies change.
+  int refinedDirCnt = 0;
+  if (tol.adaptiveDirections
+      && levels.size() < maxDirections
+      && ( (numIter%addEndogFreq) == addEndogFreq-1))
+    refinedDirCnt = refineDirections(maxDirections);
+
+  if (refinedDirCnt)
+    {
+      cout << "Added " << refinedDirCnt << " directions by refinement." << endl;
+    }
+
+  // If there are still fewer directions than the max, add a new face
   // direction to the front
     
   int endogDirCnt = 0;
-  int currNumDirs = directions.size();
+  int currNumDirs = levels.size();
   if (addEndogenous
-      && directions.size() < maxDirections
+      && levels.size() < maxDirections
       && ( (numIter%addEndogFreq) == addEndogFreq-1))
     {
+      // Index over the current directions and the faces added so
+      // far, which are identified by their order in dirPolicies. The
+      // faces are only added to levels at the end, so the indices of
+      // the current directions do not change.
+      SGDirectionIndex dirIndex(levels);
+      vector<DirectionPolicy> dirPolicies(policies);
+      vector<SGPoint> faceDirs;
+      vector< vector<double> > faceLevels;
+
       for (int k = 0; k < maxDirections-currNumDirs; k++)
 	// for (int k = 0; k < 40; k++)
       // while (directions.size() < maxDirections)
@@ -231,6 +323,10 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
 	  // if (rotateDir.norm() > 1e-6)
 	  //   rotateDir /= rotateDir.norm();
 
+	  // Start from the policy of the nearest direction.
+	  const int neighbor = dirIndex.nearest(startDir/startDir.norm());
+	  if (neighbor >= 0)
+	    loadPolicy(pivot,actionTuple,regimeTuple,dirPolicies[neighbor]);
 	  optimizePolicy(pivot,actionTuple,regimeTuple,startDir,actions);
 
 	  double bestLevel = 0.0;
@@ -270,31 +366,34 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
 	  if (faceDir.norm() >= 1e-6)
 	    faceDir /= faceDir.norm();
 
-	  bool alreadyPresent = false;
-	  for (auto dit = directions.cbegin();
-	       dit != directions.cend();
-	       dit++)
-	    {
-	      if (SGPoint::distance(*dit,faceDir)<1e-5)
-		{
-		  alreadyPresent = true;
-		  break;
-		}
-	    }
-
-	  if (alreadyPresent)
+	  if (dirIndex.contains(faceDir,1e-5))
 	    continue;
 
 	  endogDirCnt++;
 	  optimizePolicy(pivot,actionTuple,regimeTuple,faceDir,actions);
-	  directions.push_front(faceDir);
-	  levels.push_front( vector<double>(numStates,0.0));
+	  faceLevels.push_back(vector<double>(numStates,0.0));
 	  for (int s = 0; s < numStates; s++)
-	    levels.front()[s] = pivot[s]*faceDir;
+	    faceLevels.back()[s] = pivot[s]*faceDir;
+	  faceDirs.push_back(faceDir);
+	  dirIndex.insert(faceDir);
+	  dirPolicies.push_back(recordPolicy(pivot,actionTuple,regimeTuple));
 	  
-	  if (directions.size()==maxDirections)
+	  if (currNumDirs+endogDirCnt==maxDirections)
 	    break;
 	}
+
+      // Each face goes in front of the ones added before it.
+      levels.reserve(currNumDirs+endogDirCnt);
+      for (int f = 0; f < faceDirs.size(); f++)
+	levels.push_front(faceDirs[f],faceLevels[f]);
+      policies.clear();
+      policies.insert(policies.end(),
+		      std::make_move_iterator(dirPolicies.rbegin()),
+		      std::make_move_iterator(dirPolicies.rbegin()+endogDirCnt));
+      policies.insert(policies.end(),
+		      std::make_move_iterator(dirPolicies.begin()),
+		      std::make_move_iterator(dirPolicies.begin()+currNumDirs));
+      dirVertices.insert(dirVertices.begin(),endogDirCnt,-1);
     }
 
   if (endogDirCnt)
@@ -317,19 +416,19 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
 			     abs(threatTuple[state][player] + newLevels[state]));
 	    threatTuple[state][player] = -1.0*newLevels[state];
 	  }
-	if (env.getParam(SG::STOREITERATIONS))
+	if (tol.storeIterations)
 	  iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
-				SGHyperplane(*dit,newLevels),actions));
+				SGHyperplane(*dit,newLevels)));
 
 	++dit;
       }
   }
   // cout << "New threat tuple: " << threatTuple << endl;
 
-  if (env.getParam(SG::STOREITERATIONS)==2
-      || (env.getParam(SG::STOREITERATIONS)==1
-	  && ( errorLevel < env.getParam(SG::ERRORTOL)
-	       || numIter+1 >= env.getParam(SG::MAXITERATIONS) ) ) )
+  if (tol.storeIterations==2
+      || (tol.storeIterations==1
+	  && ( errorLevel < tol.errorTol
+	       || numIter+1 >= tol.maxIterations ) ) )
     soln.push_back(iter); // Important to do this before updating
   // the threat point and minIC of the
   // actions
@@ -339,22 +438,10 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
   // Recalculate minimum IC continuation payoffs
   int redundDirCnt = 0;
   {
-    // Reset the trimmed points
-    for (int state = 0; state < numStates; state++)
-      {
-	for (auto ait = actions[state].begin();
-	     ait != actions[state].end();
-	     ++ait)
-	  {
-	    ait->calculateMinIC(game,threatTuple);
-	    ait->resetTrimmedPoints(payoffUB);
-	  }
-      }
-
     // Go through the half spaces in a random order.
-    std::vector<int> order(directions.size(),0);
-    vector<bool> redundant(directions.size(),true);
-    std::uniform_int_distribution<int> intDistr2(0.0,directions.size()-1);
+    std::vector<int> order(levels.size(),0);
+    vector<bool> redundant(levels.size(),true);
+    std::uniform_int_distribution<int> intDistr2(0.0,levels.size()-1);
     for (int d =0; d < order.size(); d++)
       {
     	order[d] = d;
@@ -365,75 +452,7 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
     	std::swap(order[d],order[k]);
       }
     
-    list<SGPoint>::iterator dir = directions.begin();
-    list< vector< double> >::iterator lvl = levels.begin();
-    int dirCnt = 0;
-    // while (dir != directions.end())
-    for (int d = 0; d < order.size(); d++)
-      {
-	while (dirCnt < order[d])
-	  {
-	    dir++;
-	    lvl++;
-	    dirCnt++;
-	  }
-	while (dirCnt > order[d])
-	  {
-	    dir--;
-	    lvl--;
-	    dirCnt--;
-	  }
-	
-	for (int state = 0; state < numStates; state++)
-	  {
-	    for (auto ait = actions[state].begin();
-		 ait != actions[state].end();
-		 ++ait)
-	      {
-		// Compute the expected level
-
-		// cout  << "direction: " << dirCnt++ << endl;
-
-		double expLevel = 0;
-		for (int sp = 0; sp < numStates; sp++)
-		  expLevel += probabilities[state][ait->getAction()][sp]
-		    * (*lvl)[sp];
-		    
-		// Trim the action
-		if(ait->trim(*dir,expLevel))
-		  {
-		    redundant[order[d]]=false;
-		  }
-	      } // for ait
-	  } // for state
-      } // whiledir
-
-    dir = threatDirections.begin();
-    dirCnt = 0;
-    while (dir != threatDirections.end())
-      {
-	for (int state = 0; state < numStates; state++)
-	  {
-	    for (auto ait = actions[state].begin();
-		 ait != actions[state].end();
-		 ++ait)
-	      {
-		// Compute the expected level
-
-		// cout  << "direction: " << dirCnt++ << endl;
-
-		double expLevel = 0;
-		for (int sp = 0; sp < numStates; sp++)
-		  expLevel += probabilities[state][ait->getAction()][sp]
-		    * threatTuple[sp][dirCnt];
-		    
-		// Trim the action
-		ait->trim(*dir,expLevel);
-	      } // for ait
-	  } // for state
-	dir++;
-	dirCnt++;
-      }
+    trimActions(order,redundant,true);
 
     // Every once in awhile, don't drop directions, to make sure we
     // get an accurate measure of the hausdorff distance.
@@ -441,22 +460,26 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
 	&& numIter > dropAfterThisIter
 	&& numIter%addEndogFreq!= 1) 
       {
-	dir=directions.begin();
-	lvl = levels.begin();
-	for (int d = 0; d < order.size(); d++)
+	for (int d = 0; d < redundant.size(); d++)
 	  {
 	    if (redundant[d])
+	      redundDirCnt++;
+	  }
+	levels.erase(redundant);
+	int kept = 0;
+	for (int d = 0; d < redundant.size(); d++)
+	  {
+	    if (!redundant[d])
 	      {
-		redundDirCnt++;
-		directions.erase(dir++);
-		levels.erase(lvl++);
-	      }
-	    else
-	      {
-		dir++;
-		lvl++;
+		dirVertices[kept] = dirVertices[d];
+		policies[kept++] = std::move(policies[d]);
 	      }
 	  }
+	policies.resize(kept);
+	dirVertices.resize(kept);
+
+	if (tol.adaptiveDirections)
+	  coarsenDirections();
       }
     
     if (redundDirCnt)
@@ -465,23 +488,328 @@ double SGSolver_MaxMinMax_3Player::iterate(const int maxDirections,
 
   numRedundDirs += redundDirCnt;
   numEndogDirs += endogDirCnt;
+  numRefinedDirs += refinedDirCnt;
   
-  if (endogDirCnt)
+  if (endogDirCnt || refinedDirCnt)
     errorLevel = 1.0;
   
 
   return errorLevel;
 } // iterate
 
+int SGSolver_MaxMinMax_3Player::refineDirections(const int maxDirections)
+{
+  // Column of levels of each vertex of the mesh, or -1 if it has
+  // been dropped as redundant.
+  vector<int> vertexDirs(mesh.numVertices(),-1);
+  for (int d = 0; d < dirVertices.size(); d++)
+    {
+      if (dirVertices[d] >= 0)
+	vertexDirs[dirVertices[d]] = d;
+    }
+
+  // Find the leaf triangles whose corners have different policies,
+  // and the gap between the half spaces and the payoffs of the
+  // corners in the direction of the triangle's centroid. errorLevel
+  // is the movement of the levels in this iteration so far, and
+  // refining while it exceeds the gaps would spend directions on
+  // payoffs that are still changing.
+  vector< pair<double,int> > candidates;
+  for (int t : mesh.leaves())
+    {
+      if (mesh.wasCoarsened(t)
+	  || mesh.getDepth(t) >= maxMeshDepth)
+	continue;
+
+      int corners[3];
+      bool allPresent = true;
+      for (int k = 0; k < 3; k++)
+	{
+	  corners[k] = vertexDirs[mesh.corner(t,k)];
+	  allPresent = allPresent && corners[k] >= 0;
+	}
+      if (!allPresent)
+	continue;
+
+      bool samePolicy = true;
+      for (int i = 1; i < 3; i++)
+	samePolicy = (samePolicy
+		      && policies[corners[i]].actions == policies[corners[0]].actions
+		      && policies[corners[i]].regimes == policies[corners[0]].regimes);
+      if (samePolicy)
+	continue;
+
+      // The centroid direction c is the sum of the corners divided by
+      // its norm, so the half spaces of the corners bound payoffs in
+      // direction c by the sum of their levels divided by the same
+      // norm. The gap is how far the best corner payoff falls short
+      // of that bound.
+      SGPoint centroid = SGPoint(numPlayers,0.0);
+      for (int i = 0; i < 3; i++)
+	centroid += levels.getDirection(corners[i]);
+      const double norm = centroid.norm();
+      centroid /= norm;
+      double gap = 0;
+      for (int state = 0; state < numStates; state++)
+	{
+	  double outer = 0;
+	  double inner = -std::numeric_limits<double>::max();
+	  for (int i = 0; i < 3; i++)
+	    {
+	      outer += levels.level(corners[i],state)/norm;
+	      inner = max(inner,policies[corners[i]].pivot[state]*centroid);
+	    }
+	  gap = max(gap,outer-inner);
+	}
+      if (gap > std::max(errorLevel,tol.errorTol))
+	candidates.push_back(pair<double,int>(gap,t));
+    }
+
+  // Refine the triangles with the largest gaps first.
+  std::stable_sort(candidates.begin(),candidates.end(),
+		   [](const pair<double,int> & c0, const pair<double,int> & c1)
+		   { return c0.first > c1.first; });
+
+  int numAdded = 0;
+  for (const auto & candidate : candidates)
+    {
+      const int t = candidate.second;
+      if (levels.size()+3 > maxDirections)
+	break;
+
+      int corners[3];
+      for (int k = 0; k < 3; k++)
+	corners[k] = vertexDirs[mesh.corner(t,k)];
+
+      vector<int> added;
+      mesh.refine(t,added);
+      vertexDirs.resize(mesh.numVertices(),-1);
+      for (int k = 0; k < 3; k++)
+	{
+	  // Midpoints that are shared with a refined neighbour may
+	  // already be present.
+	  const int v = mesh.edgeMidpoint(t,k);
+	  if (vertexDirs[v] >= 0)
+	    continue;
+
+	  // Start from the policy of the corner that is highest in the
+	  // new direction.
+	  const SGPoint & dir = mesh.getVertex(v);
+	  int best = corners[0];
+	  double bestLevel = -std::numeric_limits<double>::max();
+	  for (int d : corners)
+	    {
+	      double level = 0;
+	      for (int state = 0; state < numStates; state++)
+		level += policies[d].pivot[state]*dir;
+	      if (level > bestLevel)
+		{
+		  bestLevel = level;
+		  best = d;
+		}
+	    }
+
+	  SGTuple pivot = threatTuple;
+	  vector<SGActionID> actionTuple(numStates,0);
+	  vector<SG::Regime> regimeTuple(numStates,SG::Binding);
+	  loadPolicy(pivot,actionTuple,regimeTuple,policies[best]);
+	  optimizePolicy(pivot,actionTuple,regimeTuple,dir,actions);
+
+	  vector<double> newLevels(numStates,0.0);
+	  for (int state = 0; state < numStates; state++)
+	    newLevels[state] = pivot[state]*dir;
+	  levels.push_back(dir,newLevels);
+	  policies.push_back(recordPolicy(pivot,actionTuple,regimeTuple));
+	  dirVertices.push_back(v);
+	  vertexDirs[v] = levels.size()-1;
+	  numAdded++;
+	}
+    }
+
+  return numAdded;
+} // refineDirections
+
+void SGSolver_MaxMinMax_3Player::coarsenDirections()
+{
+  vector<bool> present(mesh.numVertices(),false);
+  for (int d = 0; d < dirVertices.size(); d++)
+    {
+      if (dirVertices[d] >= 0)
+	present[dirVertices[d]] = true;
+    }
+
+  // Merge the children of refined triangles whose edge midpoints
+  // have all been dropped. Parents come before their children, so
+  // each pass goes up at most one level.
+  for (int t = 0; t < mesh.numTriangles(); t++)
+    {
+      if (!mesh.isCoarsenable(t))
+	continue;
+
+      bool allDropped = true;
+      for (int k = 0; k < 3; k++)
+	allDropped = allDropped && !present[mesh.edgeMidpoint(t,k)];
+      if (!allDropped)
+	continue;
+
+      vector<int> removed;
+      mesh.coarsen(t,removed);
+    }
+} // coarsenDirections
+
+void SGSolver_MaxMinMax_3Player::trimActions(const vector<int> & order,
+					     vector<bool> & redundant,
+					     bool trimThreats)
+{
+  // Split each state's actions into chunks. Within a state, actions
+  // are sorted by transition row, so actions that share a row are
+  // adjacent, and the expected levels of each distinct row in a chunk
+  // are computed once, in one call to SGLevelMatrix::expectedLevels.
+  const int chunkSize = 32;
+  vector< vector<SGAction_MaxMinMax *> > chunks;
+  for (int state = 0; state < numStates; state++)
+    {
+      vector<SGAction_MaxMinMax *> stateActions(actions[state].size());
+      for (SGActionID id = 0; id < actions[state].size(); id++)
+	stateActions[id] = &actions[state][id];
+      std::stable_sort(stateActions.begin(),stateActions.end(),
+		       [&](const SGAction_MaxMinMax * a0,
+			   const SGAction_MaxMinMax * a1)
+		       {
+			 return (game.getTransitionRowID(state,a0->getAction())
+				 < game.getTransitionRowID(state,a1->getAction()));
+		       });
+
+      for (int i = 0; i < stateActions.size(); i++)
+	{
+	  if (i == 0
+	      || chunks.back().size() == chunkSize)
+	    chunks.push_back(vector<SGAction_MaxMinMax *>());
+	  chunks.back().push_back(stateActions[i]);
+	}
+    }
+
+  vector<SGPoint> dirs(levels.size());
+  for (int d = 0; d < levels.size(); d++)
+    dirs[d] = levels.getDirection(d);
+
+  // Minimum IC continuation values of every action profile
+  vector< vector<SGPoint> > minICs(numStates);
+  threadPool->parallelFor(numStates,[&](int state)
+    {
+      game.minICPayoffs(state,threatTuple,minICs[state]);
+    });
+
+  // Each chunk of actions records which directions were not
+  // redundant. The chunks are merged afterwards, so the result does
+  // not depend on the number of threads.
+  vector< vector<char> > chunkRedundant(chunks.size(),
+					vector<char>(levels.size(),true));
+
+  threadPool->parallelFor(chunks.size(),[&](int c)
+    {
+      const vector<SGAction_MaxMinMax *> & chunk = chunks[c];
+      const int stride = levels.getStride();
+
+      // Distinct transition rows in the chunk, and the row of each
+      // action.
+      vector<const SGAction_MaxMinMax *> rowActions;
+      vector<int> rowIndex(chunk.size());
+      for (int i = 0; i < chunk.size(); i++)
+	{
+	  if (i == 0
+	      || (game.getTransitionRowID(chunk[i]->getState(),chunk[i]->getAction())
+		  != game.getTransitionRowID(chunk[i-1]->getState(),
+					     chunk[i-1]->getAction())))
+	    rowActions.push_back(chunk[i]);
+	  rowIndex[i] = rowActions.size()-1;
+	}
+
+      SGLevelMatrix::AlignedVector expLevels(rowActions.size()*stride);
+      if (game.hasSparseTransitions())
+	{
+	  vector<SGTransitionRow> rows(rowActions.size());
+	  for (int r = 0; r < rowActions.size(); r++)
+	    rows[r] = game.getTransitionRow(rowActions[r]->getState(),
+					    rowActions[r]->getAction());
+	  levels.expectedLevels(rows,expLevels.data());
+	}
+      else
+	{
+	  vector<const vector<double> *> probs(rowActions.size());
+	  for (int r = 0; r < rowActions.size(); r++)
+	    probs[r] = &game.getDenseTransitionRow(rowActions[r]->getState(),
+						   rowActions[r]->getAction());
+	  levels.expectedLevels(probs,expLevels.data());
+	}
+
+      // Expected threat levels, by distinct row and threat direction
+      vector<double> threatLevels;
+      vector<char> threatLevelsDone;
+      if (trimThreats)
+	{
+	  threatLevels.resize(rowActions.size()*threatDirections.size());
+	  threatLevelsDone.resize(threatLevels.size(),false);
+	}
+
+      for (int i = 0; i < chunk.size(); i++)
+	{
+	  SGAction_MaxMinMax & action = *chunk[i];
+	  action.setMinICPayoffs(minICs[action.getState()][action.getAction()]);
+	  action.resetTrimmedPoints(payoffUB);
+
+	  // Go through the half spaces in the given order
+	  const double * actionLevels = &expLevels[rowIndex[i]*stride];
+	  for (int d = 0; d < order.size(); d++)
+	    {
+	      if (action.trim(dirs[order[d]],actionLevels[order[d]]))
+		chunkRedundant[c][order[d]] = false;
+	    } // for d
+
+	  if (!trimThreats)
+	    continue;
+
+	  int dirCnt = 0;
+	  for (auto dir = threatDirections.cbegin();
+	       dir != threatDirections.cend();
+	       ++dir, ++dirCnt)
+	    {
+	      const int k = rowIndex[i]*threatDirections.size()+dirCnt;
+	      if (!threatLevelsDone[k])
+		{
+		  double expLevel = 0;
+		  game.forEachTransition(action.getState(),action.getAction(),
+					 [&](int sp, double prob)
+		    { expLevel += prob * threatTuple[sp][dirCnt]; });
+		  threatLevels[k] = expLevel;
+		  threatLevelsDone[k] = true;
+		}
+
+	      // Trim the action
+	      action.trim(*dir,threatLevels[k]);
+	    } // for dir
+	} // for i
+    });
+
+  for (int c = 0; c < chunks.size(); c++)
+    {
+      for (int d = 0; d < redundant.size(); d++)
+	{
+	  if (!chunkRedundant[c][d])
+	    redundant[d] = false;
+	}
+    }
+} // trimActions
+
 void SGSolver_MaxMinMax_3Player::solve_endogenous()
 {
   initialize();
   
   // Main loop
 
-  while (errorLevel > env.getParam(SG::ERRORTOL))
+  while (errorLevel > tol.errorTol)
     {
-      if(numIter >= env.getParam(SG::MAXITERATIONS))
+      if(numIter >= tol.maxIterations)
         throw(SGException(SG::MAX_ITERATIONS_REACHED));
       else 
       {  
@@ -506,7 +834,7 @@ std::string SGSolver_MaxMinMax_3Player::progressString() const
   for (int state = 0; state < numStates; state++)
     ss << actions[state].size() << " ";
   ss << ")"
-     << ", numDirections = " << directions.size();
+     << ", numDirections = " << levels.size();
 
   return ss.str();
 }
@@ -519,18 +847,15 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
   SGIteration_MaxMinMax iter;
   
   // Clear the directions and levels
-  list<SGPoint> newDirections;
-  list< vector<double> > newLevels;
+  SGLevelMatrix newLevels(numPlayers,numStates);
 
   
-  vector<SGActionIter> actionTuple(numStates);
   // Pick the initial actions arbitrarily
-  for (int state = 0; state < numStates; state++)
-    actionTuple[state] = actions[state].cbegin();
+  vector<SGActionID> actionTuple(numStates,0);
       
   vector<SG::Regime> regimeTuple(numStates,SG::Binding);
 
-  if (env.getParam(SG::STOREITERATIONS))
+  if (tol.storeIterations)
     iter = SGIteration_MaxMinMax (actions,threatTuple);
 
   
@@ -578,15 +903,14 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
   SGProductPolicy initialFace(numStates,faceDir);
   computeOptimalPolicies(initialFace,pivot,faceDir,actions);
 
-  std::unordered_set<std::string> foundFaces;
+  std::unordered_set<SGPolicyHash,SGPolicyHash::Hasher> foundFaces;
   foundFaces.insert(initialFace.hash());
   std::queue<SGProductPolicy> unexploredFaces;
   unexploredFaces.push(initialFace);
-  if (env.getParam(SG::STOREITERATIONS))
+  if (tol.storeIterations)
     iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
 			  SGHyperplane(initialFace.getDir(),
-				       initialFace.getLevels()),
-			  actions));
+				       initialFace.getLevels())));
   // cout << "Initial face dir: " << faceDir << endl;
   
   //cout << "New threat tuple: " << newThreatTuple << endl;
@@ -636,15 +960,15 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 	  for (int s = 0; s < numStates; s++)
 	    {
 	      actionTuple[s] = edge.getPolicies()[s]->getAction();
-	      edge.getPolicies()[s]->getAction()->getAction();
 	      
 	      regimeTuple[s] = edge.getPolicies()[s]->getRegime();
 	      if (regimeTuple[s] == SG::Binding)
 		{
 		  const int player = edge.getPolicies()[s]->getBindingPlayer();
 		  const int point = edge.getPolicies()[s]->getBindingPoint();
-		  pivot[s] = (1-delta)*payoffs[s][actionTuple[s]->getAction()]
-		    + delta*actionTuple[s]->getPoints()[player][point];
+		  const SGAction_MaxMinMax & action = actions[s][actionTuple[s]];
+		  pivot[s] = (1-delta)*payoffs[s][action.getAction()]
+		    + delta*action.getPoints()[player][point];
 		}
 	    }
 	  policyToPayoffs(pivot,actionTuple,regimeTuple);
@@ -654,18 +978,19 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 	  // explored before, do nothing. Otherwise, add it to the
 	  // queue. For now, just try rotating in both directions.
 	  const int subState = edge.getSubState();
-	  const SGActionIter subAction = edge.getSubPolicy()->getAction();
-	  const int subActionIndex = subAction->getAction();
+	  const SGAction_MaxMinMax & subAction
+	    = actions[subState][edge.getSubPolicy()->getAction()];
+	  const int subActionIndex = subAction.getAction();
 	  SGPoint subDir = SGPoint(3,0.0);
 	  if (edge.getSubPolicy()->getRegime() == SG::NonBinding)
 	     subDir = (1-delta)*payoffs[subState][subActionIndex]
-	      + delta*pivot.expectation(probabilities[subState][subActionIndex])-pivot[subState];
+	      + delta*game.expectation(pivot,subState,subActionIndex)-pivot[subState];
 	  else
 	    {
 	      const int subPlayer = edge.getSubPolicy()->getBindingPlayer();
 	      const int subPoint = edge.getSubPolicy()->getBindingPoint();
 	      subDir = (1-delta)*payoffs[subState][subActionIndex]
-		+ delta*subAction->getPoints()[subPlayer][subPoint]-pivot[subState];
+		+ delta*subAction.getPoints()[subPlayer][subPoint]-pivot[subState];
 	    }
 
 	  rotateDir = SGPoint::cross(faceDir,subDir);
@@ -706,8 +1031,6 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 	      	   << ", new: " << newEdge;
 	      cout << endl;
 	    }
-	  std::string critEdgeHash("E_s0a1NBs1a1NB_subs0a4NB");
-
 	  if (newEdge)
 	    {
 	      foundSubDirs.push_back(subDir);
@@ -778,7 +1101,7 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 		    }
 		  
 		  // Did not find a strict improvement.
-		  string hashKey = newFace.hash();
+		  const SGPolicyHash & hashKey = newFace.hash();
 
 		  // If the new face is unexplored, add it to the
 		  // queue, and add the hash key to the set of found
@@ -787,11 +1110,10 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 		    {
 		      ++newFaceCount;
 
-		      if (env.getParam(SG::STOREITERATIONS))
+		      if (tol.storeIterations)
 			iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
 					      SGHyperplane(newFace.getDir(),
-							   newFace.getLevels()),
-					      actions));
+							   newFace.getLevels())));
 		      
 		      foundFaces.insert(hashKey);
 		      unexploredFaces.push(newFace);
@@ -810,8 +1132,8 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 
       totalEdgeCount += edgeCount;
 
-      newDirections.push_back(unexploredFaces.front().getDir());
-      newLevels.push_back(unexploredFaces.front().getLevels());
+      newLevels.push_back(unexploredFaces.front().getDir(),
+			  unexploredFaces.front().getLevels());
       unexploredFaces.pop();
       
     } // while !unexploredFaces.empty()
@@ -831,123 +1153,48 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 
       SGProductPolicy threatFace (numStates,threatDir);
       computeOptimalPolicies(threatFace,pivot,threatDir,actions);
-      newDirections.push_back(threatDir);
-      newLevels.push_back(threatFace.getLevels());
+      newLevels.push_back(threatDir,threatFace.getLevels());
       
-      if (env.getParam(SG::STOREITERATIONS))
+      if (tol.storeIterations)
 	iter.push_back(SGStep(actionTuple,regimeTuple,pivot,
 			      SGHyperplane(threatDir,
-					   threatFace.getLevels()),
-			      actions));
+					   threatFace.getLevels())));
     }
 
   // Recompute the error level
   errorLevel = 0;
   {
-    // Rather heavy handed, but do this for now.
-
-    auto dir0 = directions.cbegin(), dir1 = newDirections.cbegin();
-    auto lvl0 = levels.cbegin(), lvl1 = newLevels.cbegin();
-    while (dir1 != newDirections.cend()
-	   && lvl1 != newLevels.cend())
-      {
-	dir0 = directions.cbegin();
-	lvl0 = levels.cbegin();
-	double minDist = numeric_limits<double>::max();
-	while (dir0 != directions.cend()
-	       && lvl0 != levels.cend() )
-	  {
-	    double tmp = 0;
-	    for (int state = 0; state < numStates; state++)
-	      tmp = max(tmp,abs((*lvl0)[state]-(*lvl1)[state]));
-		  
-	    minDist = min(minDist,SGPoint::distance(*dir0,*dir1)+tmp);
-		  
-	    dir0++;
-	    lvl0++;
-	  }
-	errorLevel = max(errorLevel,minDist);
-	      
-	dir1++;
-	lvl1++;
-      }
-    dir0 = directions.cbegin(); dir1 = newDirections.cbegin();
-    lvl0 = levels.cbegin(); lvl1 = newLevels.cbegin();
-    while (dir0 != directions.cend()
-	   && lvl0 != levels.cend())
-      {
-	dir1 = newDirections.cbegin();
-	lvl1 = newLevels.cbegin();
-	double minDist = numeric_limits<double>::max();
-	while (dir1 != newDirections.cend()
-	       && lvl1 != newLevels.cend() )
-	  {
-	    double tmp = 0;
-	    for (int state = 0; state < numStates; state++)
-	      tmp = max(tmp,abs((*lvl0)[state]-(*lvl1)[state]));
-		  
-	    minDist = min(minDist,SGPoint::distance(*dir0,*dir1)+tmp);
-		  
-	    dir1++;
-	    lvl1++;
-	  }
-	errorLevel = max(errorLevel,minDist);
-	      
-	dir0++;
-	lvl0++;
-      }
+    errorLevel = max(SGLevelMatrix::pseudoHausdorff(newLevels,levels),
+		     SGLevelMatrix::pseudoHausdorff(levels,newLevels));
     errorLevel = max(errorLevel,SGTuple::distance(threatTuple,newThreatTuple));
   } // Compute new error level
   
-  if (env.getParam(SG::STOREITERATIONS)==2
-      || (env.getParam(SG::STOREITERATIONS)==1
-	  && ( errorLevel < env.getParam(SG::ERRORTOL)
-	       || numIter+1 >= env.getParam(SG::MAXITERATIONS) ) ) )
+  if (tol.storeIterations==2
+      || (tol.storeIterations==1
+	  && ( errorLevel < tol.errorTol
+	       || numIter+1 >= tol.maxIterations ) ) )
     soln.push_back(iter); // Important to do this before updating the threat point and minIC of the actions
 
   // Update the the threat tuple, directions, levels
   threatTuple = newThreatTuple;
-  directions = newDirections;
   levels = newLevels;
+  policies.clear();
       
   // Recalculate minimum IC continuation payoffs
+  {
+    vector<int> order(levels.size());
+    for (int d = 0; d < order.size(); d++)
+      order[d] = d;
+    vector<bool> redundant(levels.size(),true);
+    trimActions(order,redundant,false);
+  }
+
+  // Delete the actions that are not supportable
   for (int state = 0; state < numStates; state++)
     {
-      auto ait = actions[state].begin();
-      while (ait != actions[state].end())
-	{
-	  ait->calculateMinIC(game,threatTuple);
-	  ait->resetTrimmedPoints(payoffUB);
-
-	  // Trim the actions
-	  auto dir = directions.cbegin();
-	  auto lvl = levels.cbegin();
-	  while (dir != directions.cend()
-		 && lvl != levels.cend())
-	    {
-	      // Trim the action
-	      double expLevel = 0;
-	      for (int sp = 0; sp < numStates; sp++)
-		expLevel += probabilities[state][ait->getAction()][sp]
-		  * (*lvl)[sp];
-
-	      ait->trim(*dir,expLevel);
-
-	      dir++;
-	      lvl++;
-	    } // for dir, lvl
-	  ait->updateTrim();
-	  // ait->mergeDuplicatePoints(1e-8);
-
-	  // Delete the action if not supportable
-	  if (!(ait->supportable()))
-	    {
-	      actions[state].erase(ait++);
-	      continue;
-	    }
-	  ++ait;
-	} // for ait
-	  
+      for (auto & action : actions[state])
+	action.updateTrim();
+      eraseUnsupportable(actions[state]);
     } // for state
 
   return errorLevel;
@@ -956,8 +1203,12 @@ double SGSolver_MaxMinMax_3Player::iterate_endogenous()
 
 void SGSolver_MaxMinMax_3Player::initialize()
 {
+  tol = SGEnvSnapshot(env);
+  
   errorLevel = 1;
   numIter = 0;
+
+  threadPool = std::make_shared<SGThreadPool>(env.getParam(SG::NUMTHREADS));
   
   game.getPayoffBounds(payoffUB,payoffLB);
 
@@ -965,12 +1216,12 @@ void SGSolver_MaxMinMax_3Player::initialize()
 
   // Clear the solution
   soln.clear();
-  directions.clear();
-  levels.clear();
+  levels = SGLevelMatrix(numPlayers,numStates);
+  policies.clear();
   
   // Initialize actions with a big box as the feasible set
   actions.clear();
-  actions = vector< list<SGAction_MaxMinMax> > (numStates);
+  actions = vector< vector<SGAction_MaxMinMax> > (numStates);
 
   int numActions_grandTotal = 0;
   int numEqActions_grandTotal = 0;
@@ -981,21 +1232,22 @@ void SGSolver_MaxMinMax_3Player::initialize()
 	  for (int a=0; a<numActions_totalByState[state]; a++)
 	    {
 	      if (eqActions[state][a])
-		actions[state].push_back(SGAction_MaxMinMax(env,3,state,a));
+		actions[state].push_back(SGAction_MaxMinMax(tol,3,state,a));
 	    }
 	}
       else
 	{
 	  for (int a=0; a<numActions_totalByState[state]; a++)
-	    actions[state].push_back(SGAction_MaxMinMax(env,3,state,a));
+	    actions[state].push_back(SGAction_MaxMinMax(tol,3,state,a));
 	}
       
-      for (auto ait = actions[state].begin(); ait != actions[state].end(); ait++)
+      vector<SGPoint> minICs;
+      game.minICPayoffs(state,threatTuple,minICs);
+      for (auto & action : actions[state])
 	{
-	  ait->calculateMinIC(game,threatTuple);
-	  ait->calculateMinIC(game,threatTuple);
-	  ait->resetTrimmedPoints(payoffUB);
-	  ait->updateTrim();
+	  action.setMinICPayoffs(minICs[action.getAction()]);
+	  action.resetTrimmedPoints(payoffUB);
+	  action.updateTrim();
 	}
       numEqActions_grandTotal += actions[state].size();
       int numActions_total = 1;
@@ -1008,10 +1260,21 @@ void SGSolver_MaxMinMax_3Player::initialize()
 } // initialize
 
 void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
-						vector<SGActionIter> & actionTuple,
+						vector<SGActionID> & actionTuple,
 						vector<SG::Regime> & regimeTuple,
 						const SGPoint & currDir,
-						const vector<list<SGAction_MaxMinMax> > & actions) const
+						const vector< vector<SGAction_MaxMinMax> > & actions) const
+{
+  if (!optimizePolicy(pivot,actionTuple,regimeTuple,currDir,actions,evaluator))
+    cout << "WARNING: Maximum policy iterations reached." << endl;
+} // optimizePolicy
+
+bool SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
+						vector<SGActionID> & actionTuple,
+						vector<SG::Regime> & regimeTuple,
+						const SGPoint & currDir,
+						const vector< vector<SGAction_MaxMinMax> > & actions,
+						SGPolicyEvaluator & evaluator) const
 {
   // Do policy iteration to find the optimal pivot.
   
@@ -1021,16 +1284,21 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
   // SGTuple newPivot(numStates,SGPoint(3,0.0));
   SGTuple newPivot(pivot);
 
-  vector<SGActionIter> newActionTuple(actionTuple);
+  vector<SGActionID> newActionTuple(actionTuple);
   vector<SG::Regime> newRegimeTuple(regimeTuple);
 
   vector<bool> bestAPSNotBinding(numStates,false);
   SGTuple bestBindingPayoffs(numStates,SGPoint(3,0.0));
 
+  // Expectations only depend on the transition row, so they are
+  // computed once per row in each sweep.
+  SGExpectationCache cache(game);
+
   // policy iteration
   do
     {
       pivotError = 0;
+      cache.reset();
 
       // Look in each state for improvements
       for (int state = 0; state < numStates; state++)
@@ -1040,17 +1308,17 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 	  if (numPolicyIters > 0)
 	    bestLevel = pivot[state]*currDir;
 	  
-	  for (auto ait = actions[state].cbegin();
-	       ait != actions[state].cend();
-	       ++ait)
+	  for (SGActionID id = 0; id < actions[state].size(); id++)
 	    {
-	      int actionIndex = ait->getAction();
+	      const SGAction_MaxMinMax & action = actions[state][id];
+
+	      int actionIndex = action.getAction();
 	      
 	      // Procedure to find an improvement to the policy
 	      // function
-	      SGPoint nonBindingPayoff = payoffs[state][ait->getAction()];
+	      SGPoint nonBindingPayoff = payoffs[state][action.getAction()];
 	      nonBindingPayoff *= (1-delta);
-	      nonBindingPayoff.plusWithWeight(pivot.expectation(probabilities[state][ait->getAction()]),delta);
+	      nonBindingPayoff.plusWithWeight(cache.expectation(pivot,state,action.getAction()),delta);
 
 	      bool APSNotBinding = false;
 	      SGPoint bestAPSPayoff(numPlayers,0.0);
@@ -1062,9 +1330,9 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 	      double bestBindLvl = -numeric_limits<double>::max();
 	      for (int p = 0; p < numPlayers; p++)
 		{
-		  for (int k = 0; k < ait->getPoints()[p].size(); k++)
+		  for (int k = 0; k < action.getPoints()[p].size(); k++)
 		    {
-		      double tmpLvl = ait->getPoints()[p][k]*currDir;
+		      double tmpLvl = action.getPoints()[p][k]*currDir;
 		      if (tmpLvl > bestBindLvl)
 			{
 			  bestBindLvl = tmpLvl;
@@ -1076,8 +1344,8 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 
 		  
 	      if (bestBindingPlayer >= 0
-		  && (ait->getBndryDir(bestBindingPlayer,bestBindingPoint)
-		       *currDir > env.getParam(SG::ICTOL) ) // Can improve on the best
+		  && (action.getBndryDir(bestBindingPlayer,bestBindingPoint)
+		       *currDir > tol.icTol ) // Can improve on the best
 		  // binding payoff by moving in
 		  // along the frontier
 		  )
@@ -1085,8 +1353,8 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 		  APSNotBinding = true;
 		}
 	      else if (bestBindingPlayer >= 0)// Found a binding payoff
-		bestAPSPayoff =  (1-delta)*payoffs[state][ait->getAction()]
-		  + delta * ait->getPoints()[bestBindingPlayer][bestBindingPoint];
+		bestAPSPayoff =  (1-delta)*payoffs[state][action.getAction()]
+		  + delta * action.getPoints()[bestBindingPlayer][bestBindingPoint];
 
 	      if ( APSNotBinding // NB bestAPSPayoff has only been
 		   // set if bestAPSNotBinding == false
@@ -1103,7 +1371,7 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 			  bestBindingPayoffs[state] = bestAPSPayoff;
 			}
 		      
-		      newActionTuple[state] = ait;
+		      newActionTuple[state] = id;
 	      	      newRegimeTuple[state] = SG::NonBinding;
 	      	      newPivot[state] = nonBindingPayoff;
 		      
@@ -1115,12 +1383,12 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 		  if (bestAPSPayoff*currDir > bestLevel)
 		    {
 	      	      bestLevel = bestAPSPayoff*currDir;
-		      newActionTuple[state] = ait;
+		      newActionTuple[state] = id;
 	      	      newRegimeTuple[state] = SG::Binding;
 	      	      newPivot[state] = bestAPSPayoff;
 		    }
 		}
-	    } // ait
+	    } // id
 
 	  assert(newPivot[state].size() == numPlayers);
 	  assert(pivot[state].size() == numPlayers);
@@ -1137,7 +1405,7 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
       do
 	{
 	  // Do Bellman iteration to find new fixed point
-	  policyToPayoffs(pivot,actionTuple,regimeTuple);
+	  policyToPayoffs(pivot,actionTuple,regimeTuple,evaluator);
 
 	  anyViolation = false;
 
@@ -1175,36 +1443,16 @@ void SGSolver_MaxMinMax_3Player::optimizePolicy(SGTuple & pivot,
 	} while (anyViolation);
 
 
-      if (numPolicyIters == env.getParam(SG::MAXPOLICYITERATIONS)/2)
-	cout << "Cycling detected at direction: " << currDir << endl;
-      if (numPolicyIters >= env.getParam(SG::MAXPOLICYITERATIONS)/2)
-	{
-	  cout << "Policy iter: " << numPolicyIters
-	       << ", action tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << actionTuple[state]->getAction() << " ";
-	  cout << "), regime tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << regimeTuple[state] << " ";
-	  cout << "), new regime tuple: (";
-	  for (int state = 0; state < numStates; state++)
-	    cout << newRegimeTuple[state] << " ";
-	  cout << "), pivot error: " << scientific << pivotError;
-	  cout << endl;
-	}
-
-    } while (pivotError > env.getParam(SG::POLICYITERTOL)
-	     && ++numPolicyIters < env.getParam(SG::MAXPOLICYITERATIONS));
-
-  if (numPolicyIters >= env.getParam(SG::MAXPOLICYITERATIONS))
-    cout << "WARNING: Maximum policy iterations reached." << endl;
+    } while (pivotError > tol.policyIterTol
+	     && ++numPolicyIters < tol.maxPolicyIterations);
 
+  return numPolicyIters < tol.maxPolicyIterations;
 } // optimizePolicy
 
 bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPolicies,
 							const SGTuple & pivot,
 							const SGPoint & currDir,
-							const vector<list<SGAction_MaxMinMax> > & actions) const
+							const vector< vector<SGAction_MaxMinMax> > & actions) const
 {
   vector<bool> bestAPSNotBinding(numStates,false);
 
@@ -1213,20 +1461,22 @@ bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPol
   
   optPolicies.clear();
 
+  SGExpectationCache cache(game);
+
   // Find optimal substitutions
   for (int state = 0; state < numStates; state++)
     {
       double bestLevel = pivot[state]*currDir;
       optPolicies.setLevel(state,bestLevel);
       
-      for (auto ait = actions[state].begin();
-	   ait != actions[state].end();
-	   ++ait)
+      for (SGActionID id = 0; id < actions[state].size(); id++)
 	{
+	  const SGAction_MaxMinMax & action = actions[state][id];
+
 	  // Procedure to find an improvement to the policy
 	  // function
-	  double payoffLvl = (1-delta)*(currDir*payoffs[state][ait->getAction()]);
-	  double expPivotLvl = delta*(currDir*pivot.expectation(probabilities[state][ait->getAction()]));
+	  double payoffLvl = (1-delta)*(currDir*payoffs[state][action.getAction()]);
+	  double expPivotLvl = delta*(currDir*cache.expectation(pivot,state,action.getAction()));
 	  double nonBindingLvl = payoffLvl + expPivotLvl;
 
 	  bool APSNotBinding = false;
@@ -1238,9 +1488,9 @@ bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPol
 	  double bestBindLvl = -numeric_limits<double>::max();
 	  for (int p = 0; p < numPlayers; p++)
 	    {
-	      for (int k = 0; k < ait->getPoints()[p].size(); k++)
+	      for (int k = 0; k < action.getPoints()[p].size(); k++)
 		{
-		  double bindLvl = payoffLvl + delta*(ait->getPoints()[p][k]*currDir);
+		  double bindLvl = payoffLvl + delta*(action.getPoints()[p][k]*currDir);
 		  if (bindLvl > bestBindLvl)
 		    {
 		      bestBindLvl = bindLvl;
@@ -1255,7 +1505,7 @@ bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPol
 		      if (bindLvl-bestLevel > -optTol)
 			{
 			  optPolicies.insertPolicy(state,
-						   SGPolicy(ait,SG::Binding,p,k));
+						   SGPolicy(action,id,SG::Binding,p,k));
 			}
 		    }
 		  
@@ -1263,8 +1513,8 @@ bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPol
 	    } // player
 	  
 	  if (bestBindingPlayer < 0 // didn't find a binding payoff
-	      || (ait->getBndryDir(bestBindingPlayer,bestBindingPoint)
-		  *currDir > env.getParam(SG::ICTOL) ) // Can improve
+	      || (action.getBndryDir(bestBindingPlayer,bestBindingPoint)
+		  *currDir > tol.icTol ) // Can improve
 							// on the best
 							// binding
 							// payoff by
@@ -1288,11 +1538,11 @@ bool SGSolver_MaxMinMax_3Player::computeOptimalPolicies(SGProductPolicy & optPol
 		{
 		  bestAPSNotBinding[state] = APSNotBinding;
 		  optPolicies.insertPolicy(state,
-					   SGPolicy(ait,SG::NonBinding));
+					   SGPolicy(action,id,SG::NonBinding));
 
 		}
 	    }
-	} // ait
+	} // id
     } // state
 
   return true;
@@ -1302,7 +1552,7 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 					       const SGTuple & pivot,
 					       const SGPoint & currDir,
 					       const SGPoint & newDir,
-					       const vector<list<SGAction_MaxMinMax> > & actions) const
+					       const vector< vector<SGAction_MaxMinMax> > & actions) const
 {
   const double minIndiffLvl = 1e-13; // A level of 1e-6 eliminates
 				    // spurious edges on the
@@ -1314,28 +1564,30 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
   double bestLevel = numeric_limits<double>::max();
   bool availSubFound = false;
 
+  SGExpectationCache cache(game);
+
   // Look in each state for improvements
   for (int state = 0; state < numStates; state++)
     {
-      for (auto ait = actions[state].cbegin();
-	   ait != actions[state].cend();
-	   ++ait)
+      for (SGActionID id = 0; id < actions[state].size(); id++)
 	{
+	  const SGAction_MaxMinMax & action = actions[state][id];
+
 	  // Find the smallest weight on newDir such that this action
 	  // improves in that direction. 
 
 	  // SGPoint nonBindingPayoff = (1-delta)*payoffs[state]
-	  //   [ait->getAction()]
-	  //   + delta * pivot.expectation(probabilities[state][ait->getAction()]);
+	  //   [action.getAction()]
+	  //   + delta * pivot.expectation(probabilities[state][action.getAction()]);
 	  SGPoint nonBindingPayoff(3,0.0);
-	  nonBindingPayoff.plusWithWeight(payoffs[state][ait->getAction()],
+	  nonBindingPayoff.plusWithWeight(payoffs[state][action.getAction()],
 					  1.0-delta);
-	  nonBindingPayoff.plusWithWeight(pivot.expectation(probabilities[state][ait->getAction()]),delta);
+	  nonBindingPayoff.plusWithWeight(cache.expectation(pivot,state,action.getAction()),delta);
 
 	  // Calculate the lvl at which indifferent to the pivot
 	  double denom = newDir*nonBindingPayoff-newDir*pivot[state];
 	  double numer = (pivot[state]*currDir-nonBindingPayoff*currDir);
-	  if (abs(denom) > env.getParam(SG::NORMTOL))
+	  if (abs(denom) > tol.normTol)
 	    {
 	      nonBindingIndiffLvl = numer/denom;
 
@@ -1352,9 +1604,9 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 		  int bestBindingPoint = 0;
 		  for (int p = 0; p < numPlayers; p++)
 		    {
-		      for (int k = 0; k < ait->getPoints()[p].size(); k++)
+		      for (int k = 0; k < action.getPoints()[p].size(); k++)
 			{
-			  double tmpLvl = ait->getPoints()[p][k]*indiffDir;
+			  double tmpLvl = action.getPoints()[p][k]*indiffDir;
 			  if (tmpLvl > bestBindLvl)
 			    {
 			      bestBindLvl = tmpLvl;
@@ -1366,8 +1618,8 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 
 		  bool bestAPSNotBinding = false;
 		  if (bestBindingPlayer < 0 // didn't find a binding payoff
-		      || (ait->getBndryDir(bestBindingPlayer,bestBindingPoint)
-			  *indiffDir > env.getParam(SG::IMPROVETOL))
+		      || (action.getBndryDir(bestBindingPlayer,bestBindingPoint)
+			  *indiffDir > tol.improveTol)
 		      )
 		    {
 		      // Can improve on the best binding payoff by
@@ -1378,7 +1630,7 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 		  if ( bestAPSNotBinding // NB bestAPSPayoff has only been
 		       // set if bestAPSNotBinding == true
 		       || bestBindLvl > nonBindingPayoff*indiffDir 
-		       -env.getParam(SG::IMPROVETOL))
+		       -tol.improveTol)
 		    {
 		      // If we get to here, non-binding regime is
 		      // available in the indifferent direction, and
@@ -1398,14 +1650,14 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 	  // Now check the binding directions
 	  for (int p = 0; p < numPlayers; p++)
 	    {
-	      for (int k = 0; k < ait->getPoints()[p].size(); k++)
+	      for (int k = 0; k < action.getPoints()[p].size(); k++)
 		{
-		  SGPoint bindingPayoff = payoffs[state][ait->getAction()];
+		  SGPoint bindingPayoff = payoffs[state][action.getAction()];
 		  bindingPayoff *= 1.0-delta;
-		  bindingPayoff.plusWithWeight(ait->getPoints()[p][k],delta);
+		  bindingPayoff.plusWithWeight(action.getPoints()[p][k],delta);
 		  double denom = newDir*bindingPayoff-newDir*pivot[state];
 		  double numer = pivot[state]*currDir-bindingPayoff*currDir;
-		  if (abs(denom) > env.getParam(SG::NORMTOL))
+		  if (abs(denom) > tol.normTol)
 		    {
 		      
 		      bindingIndiffLvl = numer/denom;
@@ -1418,11 +1670,11 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 			  bool isBestBinding = true;
 			  for (int pp = 0; pp < numPlayers; pp++)
 			    {
-			      for (int kp = 0; kp < ait->getPoints()[pp].size(); kp++)
+			      for (int kp = 0; kp < action.getPoints()[pp].size(); kp++)
 				{
-				  if (ait->getPoints()[pp][kp]*indiffDir
-				      > ait->getPoints()[p][k]*indiffDir
-				      +env.getParam(SG::IMPROVETOL)) 
+				  if (action.getPoints()[pp][kp]*indiffDir
+				      > action.getPoints()[p][k]*indiffDir
+				      +tol.improveTol) 
 				    isBestBinding = false;
 				}
 			    }
@@ -1430,7 +1682,7 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 			  if (isBestBinding
 			      && (nonBindingPayoff*indiffDir
 				  >= bindingPayoff*indiffDir
-				  -env.getParam(SG::IMPROVETOL)))
+				  -tol.improveTol))
 			    {
 			      availSubFound = true;
 			      bestLevel = bindingIndiffLvl;
@@ -1444,7 +1696,7 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 		} // point
 	    } // player
 
-	} // ait
+	} // id
 
     } // state
 
@@ -1457,33 +1709,50 @@ double SGSolver_MaxMinMax_3Player::sensitivity(SGPoint & optSubDir,
 
 
 void SGSolver_MaxMinMax_3Player::policyToPayoffs(SGTuple & pivot,
-						 const vector<SGActionIter> & actionTuple,
+						 const vector<SGActionID> & actionTuple,
 						 const vector<SG::Regime> & regimeTuple) const
 {
-  // Do Bellman iteration to find new fixed point
-  int updatePivotPasses = 0;
-  double bellmanPivotGap = 0;
-  SGTuple newPivot(pivot);
+  policyToPayoffs(pivot,actionTuple,regimeTuple,evaluator);
+} // policyToPayoffs
 
-  do
+void SGSolver_MaxMinMax_3Player::loadPolicy(SGTuple & pivot,
+					    vector<SGActionID> & actionTuple,
+					    vector<SG::Regime> & regimeTuple,
+					    const DirectionPolicy & policy) const
+{
+  if (policy.actions.empty())
+    return;
+
+  pivot = policy.pivot;
+  for (int state = 0; state < numStates; state++)
     {
-      for (int state = 0; state < numStates; state++)
-	{
-	  if (regimeTuple[state] == SG::NonBinding)
-	    {
-	      newPivot[state] = payoffs[state][actionTuple[state]->getAction()];
-	      newPivot[state] *= 1.0-delta;
-	      newPivot[state].plusWithWeight(pivot.expectation(probabilities[state]
-							       [actionTuple[state]->getAction()]),
-					     delta);
-	    }
-	}
-      bellmanPivotGap = SGTuple::distance(newPivot,pivot);
-      pivot = newPivot;
-    } while (bellmanPivotGap > env.getParam(SG::UPDATEPIVOTTOL)
-	     && (++updatePivotPasses < env.getParam(SG::MAXUPDATEPIVOTPASSES) ));
-  
-  if (updatePivotPasses == env.getParam(SG::MAXUPDATEPIVOTPASSES) )
-    cout << "WARNING: Maximum pivot update passes reached." << endl;
-  
+      const SGActionID id = findAction(actions[state],
+				       policy.actions[state]);
+      actionTuple[state] = std::max(id,0);
+      regimeTuple[state] = (id >= 0 ? policy.regimes[state]
+			    : SG::Binding);
+    }
+} // loadPolicy
+
+SGSolver_MaxMinMax_3Player::DirectionPolicy
+SGSolver_MaxMinMax_3Player::recordPolicy(const SGTuple & pivot,
+					 const vector<SGActionID> & actionTuple,
+					 const vector<SG::Regime> & regimeTuple) const
+{
+  DirectionPolicy policy = {pivot,vector<int>(numStates),regimeTuple};
+  for (int state = 0; state < numStates; state++)
+    policy.actions[state] = actions[state][actionTuple[state]].getAction();
+  return policy;
+} // recordPolicy
+
+void SGSolver_MaxMinMax_3Player::policyToPayoffs(SGTuple & pivot,
+						 const vector<SGActionID> & actionTuple,
+						 const vector<SG::Regime> & regimeTuple,
+						 SGPolicyEvaluator & evaluator) const
+{
+  vector<int> actionIndices(numStates);
+  for (int state = 0; state < numStates; state++)
+    actionIndices[state] = actions[state][actionTuple[state]].getAction();
+  evaluator.setPolicy(actionIndices,regimeTuple);
+  evaluator.payoffs(pivot);
 } // policyToPayoffs
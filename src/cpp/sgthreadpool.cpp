@@ -0,0 +1,124 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#include "sgthreadpool.hpp"
+
+SGThreadPool::SGThreadPool(int numThreads):
+  task(NULL),
+  numTasks(0),
+  nextTask(0),
+  numActive(0),
+  generation(0),
+  stopping(false)
+{
+  if (numThreads <= 0)
+    numThreads = std::max(1u,std::thread::hardware_concurrency());
+
+  for (int t = 1; t < numThreads; t++)
+    workers.push_back(std::thread(&SGThreadPool::workerLoop,this));
+} // constructor
+
+SGThreadPool::~SGThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  workReady.notify_all();
+  for (auto & worker : workers)
+    worker.join();
+} // destructor
+
+void SGThreadPool::runTasks()
+{
+  int i;
+  while ((i = nextTask++) < numTasks)
+    {
+      try
+	{
+	  (*task)(i);
+	}
+      catch (...)
+	{
+	  std::lock_guard<std::mutex> lock(mtx);
+	  if (!error)
+	    error = std::current_exception();
+	}
+    }
+} // runTasks
+
+void SGThreadPool::workerLoop()
+{
+  unsigned long lastGeneration = 0;
+  while (true)
+    {
+      {
+	std::unique_lock<std::mutex> lock(mtx);
+	workReady.wait(lock,[&]{ return stopping
+	      || generation != lastGeneration; });
+	if (stopping)
+	  return;
+	lastGeneration = generation;
+      }
+
+      runTasks();
+
+      {
+	std::lock_guard<std::mutex> lock(mtx);
+	if (--numActive == 0)
+	  workDone.notify_one();
+      }
+    }
+} // workerLoop
+
+void SGThreadPool::parallelFor(int n, const std::function<void(int)> & _task)
+{
+  if (workers.empty() || n <= 1)
+    {
+      for (int i = 0; i < n; i++)
+	_task(i);
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    task = &_task;
+    numTasks = n;
+    nextTask = 0;
+    numActive = workers.size();
+    error = nullptr;
+    generation++;
+  }
+  workReady.notify_all();
+
+  runTasks();
+
+  std::exception_ptr taskError;
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    workDone.wait(lock,[&]{ return numActive == 0; });
+    task = NULL;
+    taskError = error;
+    error = nullptr;
+  }
+  if (taskError)
+    std::rethrow_exception(taskError);
+} // parallelFor
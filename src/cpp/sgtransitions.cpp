@@ -0,0 +1,195 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#include "sgtransitions.hpp"
+
+SGSparseTransitions::SGSparseTransitions(const vector< vector< vector<double> > > & dense):
+  rowStart(dense.size()),
+  states(dense.size()),
+  probs(dense.size())
+{
+  for (int state = 0; state < dense.size(); state++)
+    setState(state,dense[state]);
+} // constructor
+
+void SGSparseTransitions::setState(int state,
+				   const vector< vector<double> > & dense)
+{
+  if (state >= rowStart.size())
+    {
+      rowStart.resize(state+1);
+      states.resize(state+1);
+      probs.resize(state+1);
+    }
+
+  rowStart[state].assign(1,0);
+  states[state].clear();
+  probs[state].clear();
+  for (int action = 0; action < dense.size(); action++)
+    {
+      for (int sp = 0; sp < dense[action].size(); sp++)
+	{
+	  if (dense[action][sp] == 0)
+	    continue;
+	  states[state].push_back(sp);
+	  probs[state].push_back(dense[action][sp]);
+	}
+      rowStart[state].push_back(states[state].size());
+    }
+} // setState
+
+void SGSparseTransitions::set(int state, int action,
+			      int newState, double prob)
+{
+  vector<int> & cols = states[state];
+  vector<double> & vals = probs[state];
+  const int end = rowStart[state][action+1];
+  const int k = lower_bound(cols.begin()+rowStart[state][action],
+			    cols.begin()+end,newState) - cols.begin();
+  int shift = 0;
+  if (k < end && cols[k] == newState)
+    {
+      if (prob != 0)
+	{
+	  vals[k] = prob;
+	  return;
+	}
+      cols.erase(cols.begin()+k);
+      vals.erase(vals.begin()+k);
+      shift = -1;
+    }
+  else
+    {
+      if (prob == 0)
+	return;
+      cols.insert(cols.begin()+k,newState);
+      vals.insert(vals.begin()+k,prob);
+      shift = 1;
+    }
+  for (int a = action+1; a < rowStart[state].size(); a++)
+    rowStart[state][a] += shift;
+} // set
+
+void SGSparseTransitions::insertState(int position)
+{
+  for (int state = 0; state < states.size(); state++)
+    {
+      for (int k = 0; k < states[state].size(); k++)
+	{
+	  if (states[state][k] >= position)
+	    states[state][k]++;
+	}
+    }
+
+  rowStart.insert(rowStart.begin()+position,vector<int>{0,1});
+  states.insert(states.begin()+position,vector<int>(1,position));
+  probs.insert(probs.begin()+position,vector<double>(1,1.0));
+} // insertState
+
+void SGSparseTransitions::eraseState(int state)
+{
+  rowStart.erase(rowStart.begin()+state);
+  states.erase(states.begin()+state);
+  probs.erase(probs.begin()+state);
+
+  for (int s = 0; s < states.size(); s++)
+    {
+      int kept = 0;
+      for (int action = 0; action+1 < rowStart[s].size(); action++)
+	{
+	  const int start = rowStart[s][action];
+	  const int end = rowStart[s][action+1];
+	  rowStart[s][action] = kept;
+	  for (int k = start; k < end; k++)
+	    {
+	      if (states[s][k] == state)
+		continue;
+	      states[s][kept] = states[s][k] - (states[s][k] > state);
+	      probs[s][kept] = probs[s][k];
+	      kept++;
+	    }
+	}
+      rowStart[s].back() = kept;
+      states[s].resize(kept);
+      probs[s].resize(kept);
+    }
+} // eraseState
+
+double SGSparseTransitions::probability(int state, int action,
+					int newState) const
+{
+  const SGTransitionRow r = row(state,action);
+  const int * it = lower_bound(r.states,r.states+r.nnz,newState);
+  return ((it != r.states+r.nnz && *it == newState)
+	  ? r.probs[it-r.states] : 0.0);
+} // probability
+
+vector< vector<double> > SGSparseTransitions::denseState(int state) const
+{
+  vector< vector<double> > dense(rowStart[state].size()-1,
+				 vector<double>(rowStart.size(),0.0));
+  for (int action = 0; action < dense.size(); action++)
+    {
+      for (int k = rowStart[state][action]; k < rowStart[state][action+1]; k++)
+	dense[action][states[state][k]] = probs[state][k];
+    }
+  return dense;
+} // denseState
+
+vector< vector< vector<double> > > SGSparseTransitions::dense() const
+{
+  vector< vector< vector<double> > > dense(rowStart.size());
+  for (int state = 0; state < rowStart.size(); state++)
+    dense[state] = denseState(state);
+  return dense;
+} // dense
+
+int SGSparseTransitions::nnz() const
+{
+  int total = 0;
+  for (int state = 0; state < states.size(); state++)
+    total += states[state].size();
+  return total;
+} // nnz
+
+double SGSparseTransitions::density() const
+{
+  long numEntries = 0;
+  for (int state = 0; state < rowStart.size(); state++)
+    numEntries += static_cast<long>(rowStart[state].size()-1)*rowStart.size();
+  return (numEntries > 0 ? static_cast<double>(nnz())/numEntries : 1.0);
+} // density
+
+double SGSparseTransitions::density(const vector< vector< vector<double> > > & dense)
+{
+  long numEntries = 0, numNonzero = 0;
+  for (int state = 0; state < dense.size(); state++)
+    {
+      for (int action = 0; action < dense[state].size(); action++)
+	{
+	  numEntries += dense[state][action].size();
+	  for (int sp = 0; sp < dense[state][action].size(); sp++)
+	    numNonzero += (dense[state][action][sp] != 0);
+	}
+    }
+  return (numEntries > 0 ? static_cast<double>(numNonzero)/numEntries : 1.0);
+} // density
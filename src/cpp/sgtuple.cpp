@@ -47,6 +47,26 @@ double SGTuple::expectation(const vector<double> & prob,
   return e;
 }
 
+SGPoint SGTuple::expectation(const SGTransitionRow & row) const
+{
+  if (points.size()==0)
+    throw(SGException(SG::EMPTY_TUPLE));
+
+  SGPoint point(points.front().size(),0.0);
+  for (int k = 0; k < row.nnz; k++)
+    point += (row.probs[k] * points[row.states[k]]);
+  return point;
+}
+
+double SGTuple::expectation(const SGTransitionRow & row,
+			    int player) const
+{
+  double e = 0.0;
+  for (int k = 0; k < row.nnz; k++)
+    e += (row.probs[k] * points[row.states[k]].x[player]);
+  return e;
+}
+
 SGPoint SGTuple::average() const
 {
   if (points.size()==0)
@@ -253,6 +273,11 @@ void SGTuple::emplace(int location,const SGPoint & point)
   points.insert(points.begin()+location,point);
 }
 
+void SGTuple::resize(int newSize)
+{
+  points.resize(newSize);
+}
+
 void SGTuple::unique(double tol)
 {
   SGPointComparator comparator(tol);
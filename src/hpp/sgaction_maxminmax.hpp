@@ -33,8 +33,8 @@
 
 //! Enhanced version of SGBaseAction
 /*! Same functionality as SGBaseAction, but includes additional
-    methods for computing payoffs and a reference to a parent SGEnv
-    object to control parameters for the computation. 
+    methods for computing payoffs and a snapshot of the parameters of
+    the parent SGEnv to control the computation. 
 
     This class is used by SGSolver_MaxMinMax to implement the
     max-min-max algorithm.
@@ -44,7 +44,8 @@
 class SGAction_MaxMinMax : public SGBaseAction
 {
 private:
-  const SGEnv * env; /*!< Pointer to the parent environment. */
+  SGEnvSnapshot tol; /*!< Parameters copied from the parent
+                        environment. */
 
 
   vector<SGTuple> trimmedPoints; /*!< Stores the "trimmed" points
@@ -52,38 +53,46 @@ private:
   vector<SGTuple> trimmedBndryDirs; /*!< Stores the boundary
                                          directions for the trimmed
                                          points. */
+  SGTuple trimmedLowerBounds; /*!< Coordinate-wise lower bounds of
+                                 each player's trimmed points. Only
+                                 maintained for three players. */
+  SGTuple trimmedUpperBounds; /*!< Coordinate-wise upper bounds of
+                                 each player's trimmed points. Only
+                                 maintained for three players. */
+
+  //! Recomputes the bounds of the given player's trimmed points
+  void updateTrimmedBounds(int player);
   
 public:
   //! Default constructor
   SGAction_MaxMinMax():
-    env(new SGEnv()),
     SGBaseAction()
   {}
   
   //! Constructor
   /*! Constructs a null action associated with the given SGEnv. */
-  SGAction_MaxMinMax(const SGEnv & _env):
-    env(&_env),
-    SGBaseAction()
+  SGAction_MaxMinMax(const SGEnvSnapshot & _tol):
+    SGBaseAction(),
+    tol(_tol)
   {}
 
   //! Constructor
   /*! Grandfather in old two player code. */
-  SGAction_MaxMinMax(const SGEnv & _env,
+  SGAction_MaxMinMax(const SGEnvSnapshot & _tol,
 		     int _state,
 		     int _action):
-    SGAction_MaxMinMax(_env,2,_state,_action)
+    SGAction_MaxMinMax(_tol,2,_state,_action)
   {}
 
   //! Constructor
   /*! Constructs an action for the given state and action index in the
       given environment. */
-  SGAction_MaxMinMax(const SGEnv & _env,
+  SGAction_MaxMinMax(const SGEnvSnapshot & _tol,
 		     int _numPlayers,
 		     int _state,
 		     int _action):
-    env(&_env),
     SGBaseAction(_numPlayers,_state,_action),
+    tol(_tol),
     trimmedBndryDirs(_numPlayers,SGTuple(2,SGPoint(2,0.0)))
   {
     trimmedPoints.resize(_numPlayers);
@@ -116,6 +125,8 @@ public:
 			  SGTuple & segmentDirs);
 
   //! Intersects the IC polygon with a half space
+  /*!< Returns true if the polygon was changed. The polygon is
+     updated in place and the remaining vertices keep their order. */
   bool intersectPolygonHalfSpace(const SGPoint & normal,
 				 const double level,
 				 int player,
@@ -145,7 +156,8 @@ public:
   //! Calculates the IC constraint.
   /*! Calculates the minimum incentive compatible expected
       continuation value for the given action, relative to the given
-      threat tuple and for the given SGGame. */
+      threat tuple and for the given SGGame. Uses the deviation
+      tables of the game, see SGGame::minICPayoff. */
   static double calculateMinIC(int action,int state, int player,
   			       const SGGame & game,
   			       const SGTuple & threatTuple);
@@ -180,10 +192,30 @@ bool operator==(const SGAction_MaxMinMax & lhs,
 bool operator<(const SGAction_MaxMinMax & lhs,
 	       const SGAction_MaxMinMax & rhs);
 
-template class std::list<SGAction_MaxMinMax>;
-/*template std::list<SGAction_MaxMinMax>::const_iterator;
-  template std::list<SGAction_MaxMinMax>::iterator; */
-
-typedef list<SGAction_MaxMinMax>::const_iterator SGActionIter;
+//! Identifies an action in a solver's array of actions for a state
+/*! SGSolver_MaxMinMax and SGSolver_MaxMinMax_3Player store the
+    actions that can still be played in each state contiguously, in a
+    vector<SGAction_MaxMinMax>, in increasing order of the action's
+    index in the game. An SGActionID is the position of an action in
+    that vector. IDs are stable while an iteration is in
+    progress. Between iterations, eraseUnsupportable removes the
+    actions that can no longer be supported, which preserves the order
+    of the remaining actions but renumbers them. */
+typedef int SGActionID;
+
+//! Removes the actions that cannot be supported
+/*! Erases in a single pass the actions for which
+    SGAction_MaxMinMax::supportable returns false, preserving the
+    order of the remaining actions. Returns the number of actions
+    removed. */
+int eraseUnsupportable(vector<SGAction_MaxMinMax> & actions);
+
+//! Finds an action by its index in the game
+/*! Returns the SGActionID of the action in actions whose index in
+    the game is action, or -1 if it is not there, e.g., because it
+    has been erased. Uses a binary search, since actions are in
+    increasing order of their index in the game. */
+SGActionID findAction(const vector<SGAction_MaxMinMax> & actions,
+		      int action);
 
 #endif
@@ -115,7 +115,8 @@ public:
   //! Calculates the IC constraint.
   /*! Calculates the minimum incentive compatible expected
       continuation value for the given action, relative to the given
-      threat tuple and for the given SGGame. */
+      threat tuple and for the given SGGame. Uses the deviation
+      tables of the game, see SGGame::minICPayoff. */
   static double calculateMinIC(int action,int state, int player,
 			       const SGGame & game,
 			       const SGTuple & threatTuple);
@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <set>
+#include <cstdint>
 #include <unordered_set>
 #include <queue>
 #include <random>
@@ -0,0 +1,94 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#ifndef _SGDIRECTIONINDEX_HPP
+#define _SGDIRECTIONINDEX_HPP
+
+#include "sgcommon.hpp"
+#include "sgpoint.hpp"
+#include "sglevelmatrix.hpp"
+
+//! Spatial index over a set of directions
+/*! A k-d tree over the directions of an SGLevelMatrix, used by
+    SGSolver_MaxMinMax_3Player to check whether a new direction is
+    already present and to find the nearest existing direction.
+    Directions are identified by the order in which they were added:
+    the directions of the matrix passed to the constructor get their
+    column indices, and each call to insert returns the next id.
+
+    The tree built by the constructor is balanced, splitting each
+    node at the median of the coordinate with the largest spread.
+    Inserted directions are added as leaves. Both queries visit a
+    subtree only if its bounding slab can contain a closer point, so
+    they take \f$O(\log n)\f$ time when the directions are spread
+    over the sphere, and return the same result as a linear scan.
+
+    \ingroup src
+ */
+class SGDirectionIndex
+{
+private:
+  //! A node of the tree
+  struct Node
+  {
+    SGPoint dir; /*!< The direction stored at this node. */
+    int id; /*!< Its id. */
+    int axis; /*!< Coordinate on which the children are split. */
+    int left; /*!< Child with smaller coordinates, or -1. */
+    int right; /*!< Child with larger or equal coordinates, or -1. */
+  };
+
+  vector<Node> nodes; /*!< Nodes of the tree. The root is nodes[0]. */
+  int dimension; /*!< Number of coordinates of the directions. */
+
+  //! Builds a balanced subtree and returns its root
+  /*! The subtree holds the directions dirs[order[k]] for k from
+      begin to end-1, with ids order[k]. */
+  int build(const vector<SGPoint> & dirs, vector<int> & order,
+	    int begin, int end);
+  //! Searches the subtree at node for a closer direction than best.
+  void nearest(int node, const SGPoint & dir,
+	       int & best, double & bestDist) const;
+
+public:
+  //! Default constructor
+  SGDirectionIndex(): dimension(0) {}
+  //! Builds the index over the directions in levels
+  SGDirectionIndex(const SGLevelMatrix & levels);
+
+  //! Number of directions
+  int size() const { return nodes.size(); }
+  //! Adds a direction and returns its id.
+  int insert(const SGPoint & dir);
+
+  //! Id of the direction closest to dir in the Euclidean norm
+  /*! Ties are broken in favor of the smallest id. Returns -1 if the
+      index is empty. */
+  int nearest(const SGPoint & dir) const;
+  //! True if some direction is within distance of dir
+  /*! Distance is measured in the sup norm, as in
+      SGPoint::distance, and has to be strictly less than
+      distance. */
+  bool contains(const SGPoint & dir, double distance) const;
+}; // SGDirectionIndex
+
+#endif
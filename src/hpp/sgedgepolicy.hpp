@@ -45,6 +45,17 @@ private:
                     the policies, as we work our way through the
                     product policy. */
   int subState; /*!< State in which the policy is substituted. */
+  SGPolicyHash baseKey; /*!< Identifier for the policies in the
+                           current edge, updated as they are
+                           incremented. */
+
+  //! Replaces the policy in the given state and updates baseKey
+  void setPolicy(int state, SGPolicySet::const_iterator policy)
+  {
+    baseKey.toggle(policies[state]->getKey());
+    policies[state] = policy;
+    baseKey.toggle(policy->getKey());
+  }
   
 public:
   //! Constructor
@@ -69,8 +80,15 @@ public:
   const int getSubState() const
   { return subState; }
   //! Generates a unique identifier for the edge.
-  /*!< This identifier is used in tracking which edges have been visited. */
-  std::string hash() const;
+  /*!< This identifier is used in tracking which edges have been
+     visited. The substitution is salted so that it is distinguished
+     from the base policies. */
+  SGPolicyHash hash() const
+  {
+    SGPolicyHash key(baseKey);
+    key.toggle(subPolicy->getKey(),1);
+    return key;
+  }
   //! Increment the edge by either advancing the substitution or the base policy.
   bool operator++();
   
@@ -87,4 +87,46 @@ public:
   
 };
 
+//! Copy of the parameters that are read inside inner loops
+/*! A plain struct that is filled in from an SGEnv once, when a
+    solver is initialized, and then held by value by the solver and
+    by each SGAction_MaxMinMax. Reading a field is a single load,
+    whereas SGEnv::getParam checks the enum and indexes into a
+    vector. Since the copy is taken at initialization, changing the
+    SGEnv during a solve has no effect until the next solve.
+
+    \ingroup src
+ */
+struct SGEnvSnapshot
+{
+  double errorTol; /*!< SG::ERRORTOL */
+  double policyIterTol; /*!< SG::POLICYITERTOL */
+  double icTol; /*!< SG::ICTOL */
+  double normTol; /*!< SG::NORMTOL */
+  double improveTol; /*!< SG::IMPROVETOL */
+  double intersectTol; /*!< SG::INTERSECTTOL */
+  double subGenFactor; /*!< SG::SUBGENFACTOR */
+  double lexImproveTol; /*!< SG::LEXIMPROVETOL */
+  double lexSubOpTol; /*!< SG::LEXSUBOPTOL */
+  int maxIterations; /*!< SG::MAXITERATIONS */
+  int maxPolicyIterations; /*!< SG::MAXPOLICYITERATIONS */
+  int storeIterations; /*!< SG::STOREITERATIONS */
+  int sweepSegments; /*!< SG::SWEEPSEGMENTS */
+  int coarseDirections; /*!< SG::COARSEDIRECTIONS */
+  bool activeSet; /*!< SG::ACTIVESET */
+  bool adaptiveDirections; /*!< SG::ADAPTIVEDIRECTIONS */
+
+  //! Constructor
+  /*! Copies the default parameter values. */
+  SGEnvSnapshot(): SGEnvSnapshot(SGEnv()) {}
+
+  //! Constructor
+  /*! Copies the current parameter values of env. Not explicit, so an
+      SGEnv can be passed wherever a snapshot is expected. */
+  SGEnvSnapshot(const SGEnv & env);
+
+  //! True if the inner approximation is being computed.
+  bool doInner() const { return subGenFactor > 0; }
+}; // SGEnvSnapshot
+
 #endif
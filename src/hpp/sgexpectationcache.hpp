@@ -0,0 +1,97 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#ifndef _SGEXPECTATIONCACHE_HPP
+#define _SGEXPECTATIONCACHE_HPP
+
+#include "sgcommon.hpp"
+#include "sggame.hpp"
+
+//! Expectations of a tuple, computed once per transition row
+/*! Many action profiles share the same transition probabilities. In
+    a policy iteration sweep, the expected pivot is needed for every
+    action, but it only depends on the action's transition row. This
+    class computes it the first time a row is requested and returns
+    the stored value afterwards, until reset() is called. The same
+    applies to the expected penalties of the inner approximation.
+
+    Values are computed with SGGame::expectation and
+    SGGame::forEachTransition, so they are identical to the uncached
+    values.
+
+    \ingroup src
+ */
+class SGExpectationCache
+{
+private:
+  const SGGame & game; /*!< The game. */
+  vector<SGPoint> points; /*!< Expected tuple, by row ID. */
+  vector<double> penalties; /*!< Expected penalty, by row ID. */
+  vector<unsigned> pointStamps; /*!< Generation in which points[row]
+                                   was computed. */
+  vector<unsigned> penaltyStamps; /*!< Generation in which
+                                     penalties[row] was computed. */
+  unsigned generation; /*!< Current generation. */
+
+public:
+  //! Constructor
+  SGExpectationCache(const SGGame & _game);
+
+  //! Discards all stored values
+  /*! Must be called whenever the tuple or the penalties change. */
+  void reset() { generation++; }
+
+  //! Expectation of tuple given action in state
+  const SGPoint & expectation(const SGTuple & tuple,
+			      int state, int action)
+  {
+    const int row = game.getTransitionRowID(state,action);
+    if (pointStamps[row] != generation)
+      {
+	points[row] = game.expectation(tuple,state,action);
+	pointStamps[row] = generation;
+      }
+    return points[row];
+  }
+
+  //! Returns base plus weight times the expected penalty
+  /*! The terms are added to base one at a time, in the order of the
+      states. base and weight must not change between calls to
+      reset(). */
+  double penalty(const vector<double> & statePenalties,
+		 double base, double weight,
+		 int state, int action)
+  {
+    const int row = game.getTransitionRowID(state,action);
+    if (penaltyStamps[row] != generation)
+      {
+	double value = base;
+	game.forEachTransition(state,action,[&](int sp, double prob)
+	  { value += weight*prob*statePenalties[sp]; });
+	penalties[row] = value;
+	penaltyStamps[row] = generation;
+      }
+    return penalties[row];
+  }
+}; // SGExpectationCache
+
+#endif
@@ -27,9 +27,11 @@
 #include "sgexception.hpp"
 #include "sgtuple.hpp"
 #include "sgabstractgame.hpp"
+#include "sgtransitions.hpp"
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/serialization/utility.hpp>
+#include <boost/serialization/version.hpp>
 
 //! Describes a stochastic game
 /*! This class contains members that describe a stochastic game. 
@@ -73,7 +75,34 @@ protected:
                                                        when action
                                                        profile a is
                                                        played in state
-                                                       s. */
+                                                       s. Empty when
+                                                       sparseTransitions
+                                                       is true. */
+  bool sparseTransitions; /*!< True if the transition probabilities
+                             are stored in SGGame::sparseProbabilities
+                             instead of SGGame::probabilities. */
+  SGSparseTransitions sparseProbabilities; /*!< The transition
+                                              probabilities in
+                                              compressed form. Empty
+                                              when sparseTransitions
+                                              is false. */
+  vector< vector<int> > transitionRowIDs; /*!< transitionRowIDs[s][a]
+                                            identifies the transition
+                                            row of profile a in state
+                                            s among the distinct
+                                            transition rows of the
+                                            game. Action profiles with
+                                            identical rows share an
+                                            ID, except that
+                                            SGGame::setProbability
+                                            gives a profile whose row
+                                            it changes an ID of its
+                                            own. */
+  vector< pair<int,int> > transitionRows; /*!< The state and action
+                                             of the first profile
+                                             with each row ID. */
+  vector<int> transitionRowCounts; /*!< The number of profiles with
+                                      each row ID. */
   vector< vector<bool> > eqActions; /*!< Indicates which action profiles
 				   are allowed to be played on path in
 				   each state. By default, initialized
@@ -91,7 +120,32 @@ protected:
                                  compatibility as a constraint for
                                  player i. */
   
+  //! Chooses how the transitions are stored.
+  /*! Moves the transitions into SGGame::sparseProbabilities if the
+      fraction of nonzero probabilities is below
+      SGGame::maxSparseDensity, and into SGGame::probabilities
+      otherwise. Only one of the two holds the transitions
+      afterwards. */
+  void updateSparseTransitions();
+  //! Rebuilds SGGame::transitionRowIDs and SGGame::transitionRows.
+  void updateTransitionRows();
+  //! Updates the row ID of action in state after its row has changed.
+  /*! The profile keeps its ID if no other profile shares it, and
+      otherwise gets a new ID of its own. Unlike
+      SGGame::updateTransitionRows, does not look for another profile
+      with the same row, so the cost does not grow with the size of
+      the game. */
+  void updateTransitionRow(int state, int action);
+  //! Index offset of a one-action change by player in state.
+  /*! Profiles in which only player's action differs, by d, have
+      indices that differ by d times this step. */
+  int deviationStep(int state, int player) const;
+
   //! Serializes the game using boost.
+  /*! Version 1 stores the transitions in whichever form the game
+      holds them. Games saved by version 0 always store the dense
+      form, and are compressed when they are loaded if they are
+      sparse enough. The transition rows are rebuilt on load. */
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version)
   {
@@ -101,9 +155,36 @@ protected:
     ar & numActions;
     ar & numActions_total;
     ar & payoffs;
-    ar & probabilities;
+    if (version >= 1)
+      {
+	ar & sparseTransitions;
+	if (sparseTransitions)
+	  {
+	    ar & sparseProbabilities;
+	    if (Archive::is_loading::value)
+	      probabilities.clear();
+	  }
+	else
+	  {
+	    ar & probabilities;
+	    if (Archive::is_loading::value)
+	      sparseProbabilities = SGSparseTransitions();
+	  }
+      }
+    else
+      ar & probabilities;
     ar & eqActions;
     ar & unconstrained;
+    if (Archive::is_loading::value)
+      {
+	if (version == 0)
+	  {
+	    sparseTransitions = false;
+	    sparseProbabilities = SGSparseTransitions();
+	    updateSparseTransitions();
+	  }
+	updateTransitionRows();
+      }
   }
 
 public:
@@ -116,8 +197,11 @@ public:
     probabilities(1,vector< vector<double> > (1,vector<double> (1,1))),
     delta(0.9),
     numPlayers(2),
+    sparseTransitions(false),
     unconstrained(2,false)
-  {}
+  {
+    updateTransitionRows();
+  }
 
   //! Converts an SGAbstractGame into a SGGame
   /*! The user can derive their own class from SGAbstractGame, and
@@ -184,9 +268,106 @@ public:
   //! each state
   const vector<int> & getNumActions_total () const
   { return numActions_total; }
-  //! Returns a const reference to probabilities
-  const vector< vector< vector<double> > > & getProbabilities() const
-  {return probabilities;}
+  //! Returns a copy of the transition probabilities in dense form
+  /*! Uncompresses the sparse form if the game holds its transitions
+      that way, so the copy can be much larger than the game. Use
+      getProbability, forEachTransition, or expectation to read
+      individual transitions. */
+  vector< vector< vector<double> > > getProbabilities() const
+  {
+    return (sparseTransitions ? sparseProbabilities.dense()
+	    : probabilities);
+  }
+  //! Returns a copy of the transition probabilities in state
+  vector< vector<double> > getProbabilities(int state) const
+  {
+    return (sparseTransitions ? sparseProbabilities.denseState(state)
+	    : probabilities[state]);
+  }
+  //! Returns the probability of moving to newState
+  double getProbability(int state, int action, int newState) const
+  {
+    return (sparseTransitions
+	    ? sparseProbabilities.probability(state,action,newState)
+	    : probabilities[state][action][newState]);
+  }
+  //! True if the transitions are stored in sparse form.
+  bool hasSparseTransitions() const { return sparseTransitions; }
+  //! Returns the sparse row of transitions for action in state.
+  /*! Only valid if hasSparseTransitions() is true. */
+  SGTransitionRow getTransitionRow(int state, int action) const
+  { return sparseProbabilities.row(state,action); }
+  //! Returns the dense row of transitions for action in state.
+  /*! Only valid if hasSparseTransitions() is false. */
+  const vector<double> & getDenseTransitionRow(int state, int action) const
+  { return probabilities[state][action]; }
+  //! Calls f(sp,prob) for the transitions of action in state
+  /*! Visits the states in increasing order. Skips the states with
+      zero probability when the transitions are sparse. */
+  template<class F>
+  void forEachTransition(int state, int action, F f) const
+  {
+    if (sparseTransitions)
+      {
+	const SGTransitionRow row = sparseProbabilities.row(state,action);
+	for (int k = 0; k < row.nnz; k++)
+	  f(row.states[k],row.probs[k]);
+      }
+    else
+      {
+	const vector<double> & prob = probabilities[state][action];
+	for (int sp = 0; sp < prob.size(); sp++)
+	  f(sp,prob[sp]);
+      }
+  }
+  //! Expectation of tuple conditional on action in state
+  SGPoint expectation(const SGTuple & tuple, int state, int action) const
+  {
+    return (sparseTransitions
+	    ? tuple.expectation(sparseProbabilities.row(state,action))
+	    : tuple.expectation(probabilities[state][action]));
+  }
+  //! Expectation of player's coordinate of tuple
+  double expectation(const SGTuple & tuple, int state, int action,
+		     int player) const
+  {
+    return (sparseTransitions
+	    ? tuple.expectation(sparseProbabilities.row(state,action),player)
+	    : tuple.expectation(probabilities[state][action],player));
+  }
+  //! Number of distinct transition rows.
+  int getNumTransitionRows() const { return transitionRows.size(); }
+  //! Returns the ID of the transition row of action in state.
+  /*! Two action profiles with the same ID have identical transition
+      probabilities, so quantities that only depend on the transition
+      row can be computed once per ID. Profiles with identical rows
+      share an ID unless the row of one of them was changed by
+      SGGame::setProbability. */
+  int getTransitionRowID(int state, int action) const
+  { return transitionRowIDs[state][action]; }
+  //! Returns a state and action with the given transition row ID.
+  const pair<int,int> & getTransitionRow(int row) const
+  { return transitionRows[row]; }
+
+  //! Minimum IC continuation value of player for action in state
+  /*! The largest, over player's deviations, of
+      \f$(1-\delta)/\delta\f$ times the gain in player's payoff plus
+      the expected threat payoff after the deviation. */
+  double minICPayoff(int state, int action, int player,
+		     const SGTuple & threatTuple) const;
+  //! Minimum IC continuation values of every action profile in state
+  /*! Sets minIC[a][i] to minICPayoff(state,a,i,threatTuple). The
+      expected threat payoffs are computed once per distinct
+      transition row in the state, instead of once per action profile
+      and deviation. The deviations and their payoff gains are
+      computed on the fly, so no memory beyond minIC grows with the
+      number of deviations. */
+  void minICPayoffs(int state, const SGTuple & threatTuple,
+		    vector<SGPoint> & minIC) const;
+
+  //! Largest density for which transitions are stored in sparse form.
+  static const double maxSparseDensity;
+
   //! Returns a const reference to the payoffs
   const vector< vector<SGPoint> > & getPayoffs() const
   { return payoffs; }
@@ -267,4 +448,6 @@ public:
   friend class SGSolver;
 };
 
+BOOST_CLASS_VERSION(SGGame,1)
+
 #endif
@@ -0,0 +1,132 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#ifndef _SGGEODESICMESH_HPP
+#define _SGGEODESICMESH_HPP
+
+#include "sgcommon.hpp"
+#include "sgpoint.hpp"
+#include <map>
+
+//! Adaptive geodesic subdivision of the sphere
+/*! Starts from the 20 faces of the icosahedron. A leaf triangle can
+    be refined into four by adding the normalized midpoints of its
+    edges, and a refined triangle whose children are all leaves can be
+    coarsened again. Midpoints are shared between the triangles on
+    either side of an edge, so neighbouring patches can be refined
+    independently and a patch that is refined next to a coarse one
+    leaves a hanging vertex on their common edge.
+
+    Vertices are never deleted, so their ids are stable. A vertex is
+    active while it is a corner of at least one leaf triangle. The
+    active vertices are the directions used by
+    SGSolver_MaxMinMax_3Player::solve when SG::ADAPTIVEDIRECTIONS is
+    true.
+
+    \ingroup src
+ */
+class SGGeodesicMesh
+{
+private:
+  //! A triangle of the mesh
+  struct Triangle
+  {
+    int corners[3]; /*!< Vertex ids, counter-clockwise seen from
+                       outside. */
+    int children; /*!< Id of the first of the four children, or -1
+                     if the triangle has never been refined. The
+                     fourth child is the central one. */
+    bool leaf; /*!< True if the triangle is currently not refined. */
+    bool coarsened; /*!< True if the triangle has been coarsened. */
+    bool fixed; /*!< True if the triangle was refined by refineAll,
+                   and so cannot be coarsened. */
+    int depth; /*!< Number of refinements from a face of the
+                  icosahedron. */
+  };
+
+  vector<SGPoint> vertices; /*!< All vertices created so far. */
+  vector<int> refCounts; /*!< Number of leaf triangles at each
+                            vertex. */
+  vector<Triangle> triangles; /*!< All triangles created so far. The
+                                 first 20 are the faces of the
+                                 icosahedron. */
+  std::map< std::pair<int,int>, int > midpoints; /*!< Midpoint of each
+                                                     edge, by its
+                                                     endpoints in
+                                                     increasing
+                                                     order. */
+
+  //! Id of the midpoint of the edge from v0 to v1, creating it if needed.
+  int midpoint(int v0, int v1);
+  //! Adds a leaf triangle to the reference counts of its corners
+  /*! Appends the vertices that become active to added. */
+  void addLeaf(int t, vector<int> & added);
+  //! Removes a leaf triangle from the reference counts of its corners
+  /*! Appends the vertices that become inactive to removed. */
+  void removeLeaf(int t, vector<int> & removed);
+
+public:
+  //! Constructor
+  /*! Creates the icosahedron. All 12 vertices are active. */
+  SGGeodesicMesh();
+
+  //! Number of vertices created so far
+  int numVertices() const { return vertices.size(); }
+  //! The unit direction of vertex v
+  const SGPoint & getVertex(int v) const { return vertices[v]; }
+  //! True if vertex v is a corner of a leaf triangle
+  bool isActive(int v) const { return refCounts[v] > 0; }
+
+  //! Number of triangles created so far
+  int numTriangles() const { return triangles.size(); }
+  //! Corner k of triangle t
+  int corner(int t, int k) const { return triangles[t].corners[k]; }
+  //! True if triangle t is not refined
+  bool isLeaf(int t) const { return triangles[t].leaf; }
+  //! Number of refinements from a face of the icosahedron to triangle t
+  int getDepth(int t) const { return triangles[t].depth; }
+  //! True if triangle t has been coarsened before
+  bool wasCoarsened(int t) const { return triangles[t].coarsened; }
+  //! True if triangle t can be coarsened
+  /*! That is, if it is refined, all of its children are leaves, and
+      it was not refined by refineAll. */
+  bool isCoarsenable(int t) const;
+  //! Vertex at the midpoint of edge k of triangle t
+  /*! Edge k goes from corner k to corner k+1. Triangle t must have
+      been refined at some point. */
+  int edgeMidpoint(int t, int k) const;
+  //! Ids of the leaf triangles, in increasing order
+  vector<int> leaves() const;
+
+  //! Splits leaf triangle t into four
+  /*! Appends the vertices that become active to added. */
+  void refine(int t, vector<int> & added);
+  //! Merges the children of triangle t, which must be coarsenable
+  /*! Appends the vertices that become inactive to removed. */
+  void coarsen(int t, vector<int> & removed);
+  //! Refines every leaf triangle
+  /*! The triangles refined here can never be coarsened, so the
+      mesh never becomes coarser than this uniform refinement. */
+  void refineAll(vector<int> & added);
+}; // SGGeodesicMesh
+
+#endif
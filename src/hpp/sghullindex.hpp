@@ -0,0 +1,115 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#ifndef _SGHULLINDEX_HPP
+#define _SGHULLINDEX_HPP
+
+#include "sgcommon.hpp"
+#include "sgpoint.hpp"
+#include "sggame.hpp"
+#include "sgaction_maxminmax.hpp"
+
+//! Convex hulls of stage payoffs of actions that share a transition row
+/*! Groups the actions of one state by transition row (see
+    SGGame::getTransitionRowID). Within a group, the non-binding
+    payoff \f$(1-\delta)u(a)+\delta E[v|a]\f$ differs across actions
+    only through the stage payoff \f$u(a)\f$, so in any direction the
+    best non-binding payoff of the group is attained at a vertex of
+    the convex hull of the stage payoffs. The vertices are stored in
+    counter-clockwise order together with the angles of the outward
+    normals of the hull's edges, and the best vertex in a direction
+    is found by binary search on those angles.
+
+    Since SGSolver_MaxMinMax::lexComp compares payoffs up to a
+    tolerance, actions whose stage payoffs are within the tolerance
+    of the best one can also be selected. bestActions therefore also
+    returns the vertices within the tolerance of the best level, and
+    the actions that are not vertices but lie within the tolerance of
+    the boundary of the hull. Every other action is below the best
+    level by more than the tolerance.
+
+    Used by SGSolver_MaxMinMax::robustOptimizePolicy for two player
+    games. The index refers to actions by SGActionID, so it has to
+    be rebuilt whenever actions are erased.
+
+    \ingroup src
+ */
+class SGHullIndex
+{
+private:
+  //! Actions with the same transition row
+  struct Group
+  {
+    vector<SGActionID> actions; /*!< All actions in the group, in
+                                   increasing order. */
+    vector<SGPoint> vertices; /*!< Hull vertices, counter-clockwise. */
+    vector< vector<SGActionID> > vertexActions; /*!< Actions whose
+                                                   stage payoff equals
+                                                   each vertex. */
+    vector<double> normalAngles; /*!< Angles of the outward normals of
+                                    the edges, increasing. */
+    vector<int> normalVertices; /*!< Vertex at the start of the edge
+                                   with each normal angle. */
+    vector<SGActionID> boundaryActions; /*!< Actions that are not
+                                           vertices but are within
+                                           the tolerance of the
+                                           boundary. */
+    vector<SGPoint> boundaryPayoffs; /*!< Their stage payoffs. */
+  };
+
+  vector<Group> groups; /*!< Groups in the order of their first
+                           action. */
+  double tolerance; /*!< Distance within which stage payoffs are
+                       treated as tied. */
+
+  //! Computes the hull of the stage payoffs of a group.
+  void buildHull(Group & group, const vector<SGPoint> & stagePayoffs);
+
+public:
+  //! Default constructor
+  SGHullIndex(): tolerance(0) {}
+
+  //! Builds the index for the actions of state
+  /*! Stage payoffs within _tolerance of each other in some direction
+      are treated as tied. */
+  SGHullIndex(const SGGame & game, int state,
+	      const vector<SGAction_MaxMinMax> & actions,
+	      double _tolerance);
+
+  //! Number of groups
+  int size() const { return groups.size(); }
+  //! The actions in group g, in increasing order.
+  const vector<SGActionID> & getActions(int g) const
+  { return groups[g].actions; }
+  //! Candidates for the best stage payoff in group g in direction dir
+  /*! Sets best to the actions whose stage payoff is the best in dir,
+      with ties broken by the level in dir rotated clockwise by 90
+      degrees, as in SGSolver_MaxMinMax::lexComp. Sets nearBest to the
+      other actions whose level in dir is within the tolerance of the
+      best level. The stage payoffs of all remaining actions in the
+      group are below the best level by more than the tolerance. */
+  void bestActions(int g, const SGPoint & dir,
+		   vector<SGActionID> & best,
+		   vector<SGActionID> & nearBest) const;
+}; // SGHullIndex
+
+#endif
@@ -55,7 +55,7 @@ public:
       SGSolver_MaxMinMax::actions, so that the user can later recover
       the test directions that were available at each step. For large
       games, storing the actions can take a large amount of memory. */
-  SGIteration_MaxMinMax (const vector<list<SGAction_MaxMinMax> > & _actions,
+  SGIteration_MaxMinMax (const vector< vector<SGAction_MaxMinMax> > & _actions,
 		  const SGTuple & _threatTuple):
     threatTuple{_threatTuple}
   {
@@ -64,10 +64,8 @@ public:
     for (int state = 0; state < _actions.size(); state++)
       {
 	actions[state].reserve(_actions[state].size());
-	for (auto ait = _actions[state].begin();
-	     ait != _actions[state].end();
-	     ait++)
-	  actions[state].push_back(static_cast<SGBaseAction>(*ait));
+	for (const auto & action : _actions[state])
+	  actions[state].push_back(static_cast<SGBaseAction>(action));
       }
   }
 
@@ -0,0 +1,201 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#ifndef _SGLEVELMATRIX_HPP
+#define _SGLEVELMATRIX_HPP
+
+#include "sgcommon.hpp"
+#include "sgpoint.hpp"
+#include "sgexception.hpp"
+#include "sgtransitions.hpp"
+#include <stdlib.h>
+#include <new>
+
+//! Allocator that returns memory aligned to Alignment bytes
+template<class T, size_t Alignment>
+class SGAlignedAllocator
+{
+public:
+  typedef T value_type;
+  template<class U> struct rebind
+  { typedef SGAlignedAllocator<U,Alignment> other; };
+
+  SGAlignedAllocator() {}
+  template<class U>
+  SGAlignedAllocator(const SGAlignedAllocator<U,Alignment> &) {}
+
+  T * allocate(size_t n)
+  {
+    void * p = NULL;
+    if (n == 0)
+      return NULL;
+    if (posix_memalign(&p,Alignment,n*sizeof(T)))
+      throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+  void deallocate(T * p, size_t) { free(p); }
+
+  template<class U>
+  bool operator==(const SGAlignedAllocator<U,Alignment> &) const
+  { return true; }
+  template<class U>
+  bool operator!=(const SGAlignedAllocator<U,Alignment> &) const
+  { return false; }
+}; // SGAlignedAllocator
+
+//! Directions and levels of a collection of half spaces
+/*! Stores the normals and the per-state levels of the half spaces
+    that bound the payoff correspondence in SGSolver_MaxMinMax and
+    SGSolver_MaxMinMax_3Player. Both are kept as contiguous,
+    cache-line aligned matrices with one row per player (for the
+    directions) or per state (for the levels) and one column per
+    direction. Rows are padded to a multiple of SGLevelMatrix::width
+    columns, so every row starts on an aligned boundary.
+
+    The main operation is expectedLevels, which computes the expected
+    level \f$\sum_{s'} P(s'|s,a) l(d,s')\f$ in every direction for a
+    batch of transition rows. This is the product of the transition
+    rows and the level matrix, and is computed with a kernel that is
+    blocked over directions and vectorized along them.
+
+    \ingroup src
+ */
+class SGLevelMatrix
+{
+public:
+  //! Rows are padded to a multiple of this many columns.
+  static const int width = 8;
+
+  //! Contiguous aligned storage.
+  typedef vector<double, SGAlignedAllocator<double,64> > AlignedVector;
+
+private:
+  int numPlayers; /*!< Dimension of the directions. */
+  int numStates; /*!< Number of levels per direction. */
+  int numDirections; /*!< Number of directions stored. */
+  int stride; /*!< Allocated number of columns. */
+
+  AlignedVector directions; /*!< numPlayers by stride matrix of
+                                directions. */
+  AlignedVector levels; /*!< numStates by stride matrix of levels. */
+
+  //! Increases the number of columns to at least minColumns.
+  void reserveColumns(int minColumns);
+  //! Number of columns processed at a time by expectedLevels.
+  int blockSize() const;
+
+public:
+  //! Default constructor
+  SGLevelMatrix():
+    numPlayers(0), numStates(0), numDirections(0), stride(0)
+  {}
+  //! Constructor for an empty matrix.
+  SGLevelMatrix(int _numPlayers, int _numStates):
+    numPlayers(_numPlayers), numStates(_numStates),
+    numDirections(0), stride(0)
+  {}
+
+  //! Number of directions
+  int size() const { return numDirections; }
+  //! True if there are no directions
+  bool empty() const { return numDirections == 0; }
+  //! Number of states
+  int getNumStates() const { return numStates; }
+  //! Number of players
+  int getNumPlayers() const { return numPlayers; }
+  //! Distance between rows of the level matrix.
+  /*! Output of expectedLevels uses the same row length. */
+  int getStride() const { return stride; }
+
+  //! Coordinate of direction d for player.
+  double direction(int d, int player) const
+  { return directions[player*stride+d]; }
+  //! Level of direction d in state.
+  double & level(int d, int state)
+  { return levels[state*stride+d]; }
+  //! Level of direction d in state.
+  double level(int d, int state) const
+  { return levels[state*stride+d]; }
+  //! Returns direction d as an SGPoint.
+  SGPoint getDirection(int d) const;
+  //! Returns the levels of direction d in all states.
+  vector<double> getLevels(int d) const;
+
+  //! Adds a direction at the end.
+  void push_back(const SGPoint & dir, const vector<double> & dirLevels);
+  //! Adds a direction at the beginning.
+  void push_front(const SGPoint & dir, const vector<double> & dirLevels);
+  //! Removes the directions d for which remove[d] is true.
+  /*! Preserves the order of the remaining directions. */
+  void erase(const vector<bool> & remove);
+  //! Removes all directions.
+  void clear();
+  //! Reserves space for numDirections directions.
+  void reserve(int numDirections) { reserveColumns(numDirections); }
+
+  //! Expected levels for a batch of transition rows
+  /*! For each r, sets out[r*getStride()+d] to the expected level
+      \f$\sum_{s'} (*probs[r])[s'] \cdot l(d,s')\f$ for every
+      direction d. out must be aligned to 64 bytes and hold
+      probs.size()*getStride() elements. The terms are summed in the
+      order of the states, so the result is identical to the scalar
+      loop. */
+  void expectedLevels(const vector<const vector<double> *> & probs,
+		      double * out) const;
+  //! Expected levels for a batch of sparse transition rows
+  /*! Same as the dense version, but only visits the states in each
+      row. Gives the same result, since the dense version skips the
+      states with zero probability. */
+  void expectedLevels(const vector<SGTransitionRow> & rows,
+		      double * out) const;
+
+  //! Distance between two half spaces
+  /*! Sup norm distance between direction d0 of levels0 and direction
+      d1 of levels1, plus the largest difference in their levels
+      across states. */
+  static double distance(const SGLevelMatrix & levels0, int d0,
+			 const SGLevelMatrix & levels1, int d1);
+
+  //! One-sided pseudo-Hausdorff distance
+  /*! Returns the largest, over the half spaces in newLevels, of the
+      distance to the nearest half space in oldLevels. 
+
+      When the directions are two-dimensional unit vectors, the old
+      directions are sorted by angle, and for each new direction the
+      candidates are visited outward from its angular position in
+      both rotational directions. Since the sup norm distance between
+      unit vectors separated by an angle \f$\theta\le\pi\f$ is at
+      least \f$\sqrt{2}\sin(\theta/2)\f$, the search in each
+      direction stops once that bound exceeds the nearest distance
+      found so far. This takes \f$O(n\log n)\f$ time when the two
+      sets of directions are spread around the circle, and returns
+      exactly the same value as pseudoHausdorff_bruteForce, since the
+      minimizing candidate is always visited. Otherwise falls back to
+      pseudoHausdorff_bruteForce. */
+  static double pseudoHausdorff(const SGLevelMatrix & newLevels,
+				const SGLevelMatrix & oldLevels);
+
+  //! Quadratic reference implementation of pseudoHausdorff
+  static double pseudoHausdorff_bruteForce(const SGLevelMatrix & newLevels,
+					   const SGLevelMatrix & oldLevels);
+}; // SGLevelMatrix
+
+#endif
@@ -131,6 +131,25 @@ namespace SG
                           sufficient condition for the pivot to not
                           cut into the equilibrium payoff
                           correspondence. */
+      ACTIVESET, /*!< Experimental. If true, the endogenous sweep of
+                   SGSolver_MaxMinMax only considers a working set of
+                   actions in each state. Each revolution starts from
+                   the actions of the last revolution's optimal
+                   policies, and the set grows when a pricing pass
+                   over the other actions finds one that would change
+                   the sweep. Only the arcs on which it would are
+                   swept again. The result is the same as with all
+                   actions. This is faster when few actions are ever
+                   optimal, but slower when most actions are on the
+                   frontier, as in risk sharing, since the pricing
+                   passes then add many of them back every
+                   revolution. */
+      ADAPTIVEDIRECTIONS, /*!< If true,
+                            SGSolver_MaxMinMax_3Player::solve starts
+                            from a geodesic subdivision of the
+                            icosahedron and refines it only where the
+                            optimal policies of adjacent directions
+                            differ. */
       NUMBOOLPARAMS /*!< Used internally to indicate the number of
 		      enumerated bool parameters. */
     };
@@ -152,6 +171,28 @@ namespace SG
       TUPLERESERVESIZE, /*!< The amount by which the extremeTuples
                           member of SGApproximation is incremented
                           when the capacity is reached. */
+      NUMTHREADS, /*!< Number of threads used by the max-min-max
+                    solvers for work that can be done in
+                    parallel. If zero, uses the number of hardware
+                    threads. */
+      SWEEPSEGMENTS, /*!< If positive, the endogenous sweep of
+                       SGSolver_MaxMinMax splits the circle of
+                       directions into this many arcs, at least
+                       four, and sweeps them in parallel. If zero,
+                       the sweep is serial. */
+      COARSEDIRECTIONS, /*!< If positive, SGSolver_MaxMinMax::solve_fixed
+                          starts with this many directions, rounded up
+                          to a multiple of four, and doubles them as
+                          the error level falls until the final
+                          resolution is reached. If zero, all
+                          iterations use the final directions. This
+                          only makes the early revolutions cheaper,
+                          and does not reduce the number of
+                          revolutions. The tail of revolutions at the
+                          final resolution starts from different
+                          levels, so the final levels agree with
+                          those of a solve without it to within about
+                          SG::ERRORTOL, not exactly. */
       NUMINTPARAMS /*!< Used internally to indicate the number of
 		     enumerated int parameters. */
     };
@@ -25,40 +25,94 @@
 #define _SGPOINT_HPP
 
 #include "sgcommon.hpp"
+#include <boost/serialization/split_member.hpp>
 
 //! A vector in \f$\mathbb{R}^n\f$
 /*! A simple two-dimensional vector that supports arithmetic operations. 
 
+  Points with up to SGPoint::inlineCapacity coordinates, which covers
+  the two and three player solvers, store their coordinates inside the
+  object, so that creating, copying, and destroying temporaries never
+  touches the heap. Larger points allocate their coordinates on the
+  heap.
+
   \ingroup src
  */
 class SGPoint
 {
+public:
+  //! Largest number of coordinates stored without a heap allocation
+  static const int inlineCapacity = 3;
+
 protected:
-  vector<double> x; /*!< Two dimensional vector of doubles. */
+  int n; /*!< The number of coordinates. */
+  double * x; /*!< The coordinates. Points to buffer if n is at most
+                 inlineCapacity, and to heap memory otherwise. */
+  double buffer[inlineCapacity]; /*!< Inline storage for small
+                                    points. */
+
+  //! Points x at storage for _n coordinates.
+  void allocate(int _n)
+  {
+    n = _n;
+    x = (n <= inlineCapacity ? buffer : new double[n]);
+  }
+  //! Frees heap storage, if any.
+  void release()
+  {
+    if (x != buffer)
+      delete[] x;
+  }
 
 public:
   //! Default constructor that sets vector equal to zero.
-  SGPoint():  x(2,0.0) {}
+  SGPoint() { allocate(2); x[0] = 0.0; x[1] = 0.0; }
   //! Sets both elements of the vector equal to x.
-  SGPoint(double _x): x(2,_x) {}
+  SGPoint(double _x) { allocate(2); x[0] = _x; x[1] = _x; }
   //! Creates an n dimensional zero vector
-  SGPoint(int n): x(n,0) {}
+  SGPoint(int _n) { allocate(_n); std::fill(x,x+n,0.0); }
   //! Creates an n dimensional zero vector
-  SGPoint(int n, double _x): x(n,_x) {}
+  SGPoint(int _n, double _x) { allocate(_n); std::fill(x,x+n,_x); }
   //! Creates an SGPoint from the two-vector _x. 
-  SGPoint(vector<double> _x)
+  SGPoint(const vector<double> & _x)
   {
-    x = _x;
+    allocate(_x.size());
+    std::copy(_x.begin(),_x.end(),x);
   }
   //! Creates an SGPoint with elements x and y.
-  SGPoint(double _x0, double _x1): x(2,0.0)
-  { x[0] = _x0; x[1] = _x1;  }
+  SGPoint(double _x0, double _x1)
+  { allocate(2); x[0] = _x0; x[1] = _x1;  }
+  //! Copy constructor
+  SGPoint(const SGPoint & p)
+  {
+    allocate(p.n);
+    std::copy(p.x,p.x+n,x);
+  }
+  //! Move constructor
+  /*! Takes over the heap storage of large points, so it never
+      allocates and containers of points move rather than copy when
+      they grow. */
+  SGPoint(SGPoint && p) noexcept
+  {
+    if (p.x != p.buffer)
+      {
+	n = p.n;
+	x = p.x;
+	p.n = 0;
+	p.x = p.buffer;
+      }
+    else
+      {
+	allocate(p.n);
+	std::copy(p.x,p.x+n,x);
+      }
+  }
 
   //! Destructor
-  ~SGPoint(){}
+  ~SGPoint() { release(); }
 
   //! Returns the number of coordinates
-  int size () const {return x.size();}
+  int size () const {return n;}
   //! Returns the counter-clockwise normal vector.
   SGPoint getNormal() const;
   //! Returns the Euclidean norm.
@@ -111,7 +165,38 @@ public:
     return x[player];
   }
   //! Assignment operator
-  SGPoint& operator=(const SGPoint & rhs);
+  /*! Reuses the existing storage when the dimensions agree. */
+  SGPoint& operator=(const SGPoint & rhs)
+  {
+    if (this != &rhs)
+      {
+	if (n != rhs.n)
+	  {
+	    release();
+	    allocate(rhs.n);
+	  }
+	std::copy(rhs.x,rhs.x+n,x);
+      }
+    return *this;
+  }
+  //! Move assignment operator
+  SGPoint& operator=(SGPoint && rhs) noexcept
+  {
+    if (this != &rhs)
+      {
+	if (rhs.x != rhs.buffer)
+	  {
+	    release();
+	    n = rhs.n;
+	    x = rhs.x;
+	    rhs.n = 0;
+	    rhs.x = rhs.buffer;
+	  }
+	else
+	  *this = static_cast<const SGPoint &>(rhs);
+      }
+    return *this;
+  }
   //! Sets both coordinates equal to d.
   SGPoint& operator=(double d);
   //! Augmented addition
@@ -137,7 +222,13 @@ public:
   //! Right scalar division.
   friend SGPoint operator/(const SGPoint & point,double d);
   //! Dot product.
-  double operator*(const SGPoint & rhs) const; // dot product
+  double operator*(const SGPoint & rhs) const // dot product
+  {
+    double sum = 0;
+    for (int k = 0; k < n; k++)
+      sum += x[k]*rhs.x[k];
+    return sum;
+  }
   //! Equality
   bool operator==(const SGPoint & rhs) const;
   //! Not equls
@@ -184,12 +275,24 @@ public:
 			   const SGPoint& p1,
 			   const SGPoint& p2);
 
-  //! Serialize an SGPoint
+  //! Save an SGPoint
+  /*! The coordinates are written as a vector<double>, which is the
+      format used by earlier versions. */
+  template<class Archive>
+  void save(Archive &ar, const unsigned int version) const
+  {
+    const vector<double> coords(x,x+n);
+    ar & coords;
+  }
+  //! Load an SGPoint
   template<class Archive>
-  void serialize(Archive &ar, const unsigned int version)
+  void load(Archive &ar, const unsigned int version)
   {
-    ar & x;
+    vector<double> coords;
+    ar & coords;
+    *this = SGPoint(coords);
   }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
 
   friend class boost::serialization::access;
   friend class SGTuple;
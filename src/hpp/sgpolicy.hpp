@@ -24,8 +24,68 @@
 
 #include "sgaction_maxminmax.hpp"
 
-//! Class for storing policies
-typedef list<SGAction_MaxMinMax>::const_iterator SGActionIter;
+//! Packed identifier for a policy
+/*!< The state and game action are packed into hi, and the regime,
+   binding player, and binding point into lo, 32 bits each, so every
+   policy of every game has a key. Keys are compared lexicographically,
+   which orders policies the same way as operator< on SGPolicy. */
+struct SGPolicyKey
+{
+  uint64_t hi; /*!< State and game action. */
+  uint64_t lo; /*!< Regime code and binding point. */
+
+  //! Lexicographic comparison
+  bool operator<(const SGPolicyKey & rhs) const
+  { return hi < rhs.hi || (hi == rhs.hi && lo < rhs.lo); }
+  //! Equality
+  bool operator==(const SGPolicyKey & rhs) const
+  { return hi == rhs.hi && lo == rhs.lo; }
+}; // SGPolicyKey
+
+//! 128-bit identifier for a set of policies
+/*!< The identifier is the XOR of two independent mixes of each
+   policy's packed key, so policies can be added and removed in any
+   order. Used by SGProductPolicy and SGEdgePolicy to track which
+   faces and edges have been visited. */
+struct SGPolicyHash
+{
+  uint64_t lo; /*!< Low word. */
+  uint64_t hi; /*!< High word. */
+
+  //! Constructor for the empty set
+  SGPolicyHash(): lo(0), hi(0) {}
+
+  //! Adds or removes the policy with the given key.
+  /*! Different salts give unrelated contributions for the same
+      key. */
+  void toggle(const SGPolicyKey & key, uint64_t salt = 0)
+  {
+    const uint64_t k = mix(key.hi) + key.lo;
+    lo ^= mix(k + salt*0x9e3779b97f4a7c15ULL);
+    hi ^= mix(k*0xd6e8feb86659fd93ULL + salt + 1);
+  }
+
+  //! The splitmix64 finalizer
+  static uint64_t mix(uint64_t x)
+  {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  //! Equality
+  bool operator==(const SGPolicyHash & rhs) const
+  { return lo == rhs.lo && hi == rhs.hi; }
+
+  //! Hasher for unordered containers
+  struct Hasher
+  {
+    size_t operator()(const SGPolicyHash & h) const
+    { return h.lo; }
+  };
+}; // SGPolicyHash
+
+ostream& operator<<(ostream& out, const SGPolicyHash &);
 
 //! A policy for the max-min-max algorithm
 /*!< This class represents a policy in a single state. Part of the
@@ -33,28 +93,49 @@ typedef list<SGAction_MaxMinMax>::const_iterator SGActionIter;
 class SGPolicy
 {
 private:
-  SGActionIter action; /*!< The action. */
+  int state; /*!< The state. */
+  SGActionID action; /*!< The ID of the action in the solver's array
+                        of actions for the state. */
+  int gameAction; /*!< The index of the action profile in the
+                     game. */
   SG::Regime regime; /*!< The regime. */
   int bindingPlayer; /*!< The player with the binding incentive
                         constraint if the regime is binding. */
   int bindingPoint; /*!< The index of the binding continuation value
                        when the regime is binding. */
+  SGPolicyKey key; /*!< The state, game action, regime, binding
+                      player, and binding point, packed. */
+
+  //! Packs the policy into key
+  void pack();
 
 public:
   //! Constructor
-  SGPolicy(const SGActionIter & _action,
+  /*! _id is the ID of _action in the solver's array of actions. */
+  SGPolicy(const SGAction_MaxMinMax & _action,
+	   const SGActionID _id,
 	   const SG::Regime _regime,
 	   const int _bindingPlayer = -1,
 	   const int _bindingPoint = -1):
-    action(_action),
+    state(_action.getState()),
+    action(_id),
+    gameAction(_action.getAction()),
     regime(_regime),
     bindingPlayer(_bindingPlayer),
     bindingPoint(_bindingPoint)
-  {}
+  { pack(); }
 
+  //! State get method
+  int getState() const
+  { return state; }
   //! Action get method
-  const SGActionIter & getAction() const
+  /*! Returns the ID of the action in the solver's array of
+      actions. */
+  SGActionID getAction() const
   { return action; }
+  //! Returns the index of the action profile in the game.
+  int getGameAction() const
+  { return gameAction; }
   //! Regime get method
   const SG::Regime & getRegime() const
   { return regime; }
@@ -65,11 +146,12 @@ public:
   const int getBindingPoint() const
   { return bindingPoint; }
 
-  //! Returns a unique identifying string for the policy
-  std::string hash() const;
+  //! Returns the packed key, which uniquely identifies the policy
+  const SGPolicyKey & getKey() const
+  { return key; }
 
   //! Tests equality of two policies
-  bool isEqual(const SGActionIter & _action,
+  bool isEqual(const SGActionID _action,
 	       const SG::Regime & _regime,
 	       const int _bindingPlayer=-1,
 	       const int _bindingPoint=-1) const
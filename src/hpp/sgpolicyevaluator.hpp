@@ -0,0 +1,132 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#ifndef _SGPOLICYEVALUATOR_HPP
+#define _SGPOLICYEVALUATOR_HPP
+
+#include "sgcommon.hpp"
+#include "sgnamespace.hpp"
+#include "sgtuple.hpp"
+#include "sggame.hpp"
+#include "sgexception.hpp"
+
+//! Exact evaluation of stationary policies
+/*! Computes the payoffs generated by a policy, i.e., an action and a
+    regime in each state, by solving the linear system
+
+    \f[ v(s) = (1-\delta) u(s,a(s)) + \delta \sum_{s'} P(s'|s,a(s)) v(s') \f]
+
+    in the non-binding states, while holding the payoffs in binding
+    states fixed at their current values. Equivalently, the class
+    solves \f$ A v = b \f$, where the row of \f$A\f$ for a
+    non-binding state is \f$ e_s - \delta P(\cdot|s,a(s)) \f$ and the
+    row for a binding state is \f$ e_s \f$. \f$A\f$ is strictly
+    diagonally dominant for \f$\delta<1\f$.
+
+    The class stores \f$A^{-1}\f$. When the action or regime changes
+    in a single state, only one row of \f$A\f$ changes, and the
+    inverse is updated with the Sherman-Morrison formula at cost
+    \f$O(S^2)\f$. The inverse is rebuilt from scratch by Gaussian
+    elimination when many states change at once, or after
+    maxRankOneUpdates consecutive updates to contain round-off.
+
+    Used by SGSolver_MaxMinMax and SGSolver_MaxMinMax_3Player in
+    place of Bellman iteration.
+
+    \ingroup src
+ */
+class SGPolicyEvaluator
+{
+private:
+  const SGGame * game; /*!< The game whose policies are evaluated. */
+  double delta; /*!< The discount factor. */
+  int numStates; /*!< The number of states. */
+
+  vector<int> actions; /*!< The action played in each state under
+			   the current policy. -1 if the policy has
+			   not been set. */
+  vector<SG::Regime> regimes; /*!< The regime in each state under the
+				  current policy. */
+  vector<double> inverse; /*!< Row-major inverse of the matrix A for
+			      the current policy. */
+  vector<double> column; /*!< Workspace for the rank-one update. */
+  vector<double> row; /*!< Workspace for the rank-one update. */
+  vector<double> diff; /*!< Workspace for the rank-one update. */
+  int numUpdates; /*!< Number of rank-one updates since the inverse
+		     was last rebuilt. */
+
+  //! Maximum number of rank-one updates before refactorizing.
+  static const int maxRankOneUpdates = 32;
+
+  //! Writes the row of A for state into rowOut.
+  void matrixRow(int state, int action, SG::Regime regime,
+		 vector<double> & rowOut) const;
+  //! Rebuilds the inverse by Gauss-Jordan elimination.
+  void factorize();
+  //! Replaces the row of A for the given state.
+  /*! Applies the Sherman-Morrison update to the inverse. Returns
+      false if the update is numerically unreliable, in which case
+      the inverse has not been modified. */
+  bool rankOneUpdate(int state, int action, SG::Regime regime);
+  //! Right hand side of the linear system for pivot.
+  void rightHandSide(const SGTuple & pivot, SGTuple & rhs) const;
+  //! Overwrites the payoff of a non-binding state in pivot.
+  void statePayoff(int state, const SGTuple & rhs, SGTuple & pivot) const;
+
+public:
+  //! Default constructor
+  SGPolicyEvaluator(): game(NULL), delta(0), numStates(0), numUpdates(0)
+  {}
+  //! Constructor
+  SGPolicyEvaluator(const SGGame & _game);
+
+  //! Sets the policy to be evaluated.
+  /*! Compares the new policy with the current one and updates the
+      stored inverse accordingly. */
+  void setPolicy(const vector<int> & newActions,
+		 const vector<SG::Regime> & newRegimes);
+
+  //! Computes the payoffs of the current policy.
+  /*! Payoffs in binding states are taken from pivot and are left
+      unchanged. Payoffs in non-binding states are overwritten with
+      the exact fixed point. */
+  void payoffs(SGTuple & pivot) const;
+  //! Computes the payoffs of the current policy in some states.
+  /*! Only overwrites the payoffs of the non-binding states among
+      states, at cost proportional to their number. The other
+      payoffs in pivot must already be those of the current
+      policy. */
+  void payoffs(SGTuple & pivot, const vector<int> & states) const;
+
+  //! Computes the penalties of the current policy.
+  /*! Penalties solve \f$ p(s) = c + \delta \sum_{s'} P(s'|s,a(s))
+      p(s') \f$ in non-binding states and \f$p(s)=c\f$ in binding
+      states, where \f$c\f$ is subGenFactor. */
+  void penalties(vector<double> & penalties,
+		 double subGenFactor) const;
+  //! Computes the penalties of the current policy in some states.
+  /*! Only overwrites the penalties of states, which must have size
+      getNumStates(). */
+  void penalties(vector<double> & penalties, double subGenFactor,
+		 const vector<int> & states) const;
+}; // SGPolicyEvaluator
+
+#endif
@@ -24,13 +24,8 @@
 
 #include "sgpolicy.hpp"
 
-//! Function object for comparing two policies
-struct policyComp {
-  bool operator() (const SGPolicy & lhs, const SGPolicy & rhs)
-  { return lhs < rhs;}
-};
-
-typedef set<SGPolicy,policyComp> SGPolicySet;
+//! Policies in a single state, sorted by their packed keys
+typedef vector<SGPolicy> SGPolicySet;
 
 //! Class for storing product policies
 /*!< This class is part of the routine for the exact computation of
@@ -40,6 +35,9 @@ class SGProductPolicy
 private:
   vector<SGPolicySet> policies; /*!< The vector of sets of policies
                                    for each state. */
+  SGPolicyHash key; /*!< Identifier for the product policy,
+                       updated as policies are inserted and
+                       removed. */
   SGPoint dir; /*!< The direction in which these policies are optimal. */
   vector<double> levels; /*!< The associated optimal levels. */
 
@@ -67,22 +65,10 @@ public:
   { return levels; }
 
   //! Inserts a new policy in the given state
-  void insertPolicy(int state, const SGPolicy & policy)
-  {
-    if (state >= policies.size() || state<0)
-      throw(SGException(SG::OUT_OF_BOUNDS));
-
-    policies[state].insert(policy);
-  }
+  void insertPolicy(int state, const SGPolicy & policy);
 
   //! Removes a policy from the given state
-  void erasePolicy(int state, const SGPolicy & policy)
-  {
-    if (state >= policies.size() || state<0)
-      throw(SGException(SG::OUT_OF_BOUNDS));
-
-    policies[state].erase(policy);
-  }
+  void erasePolicy(int state, const SGPolicy & policy);
 
   //! Sets the level in a given state
   void setLevel(int state, double lvl)
@@ -98,6 +84,7 @@ public:
   {
     for (int state = 0; state < policies.size(); state++)
       policies[state].clear();
+    key = SGPolicyHash();
   }
 
   //! Returns whether the policy set is empty in any state
@@ -123,7 +110,8 @@ public:
   }
 
   //! Returns a unique identifier for the product policy
-  std::string hash() const;
+  const SGPolicyHash & hash() const
+  { return key; }
 
   //! Returns the number of states.
   int numStates() const {return policies.size();}
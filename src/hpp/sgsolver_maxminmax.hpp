@@ -29,6 +29,78 @@
 #include "sgaction_maxminmax.hpp"
 #include "sgexception.hpp"
 #include "sgsolution_maxminmax.hpp"
+#include "sgpolicyevaluator.hpp"
+#include "sgthreadpool.hpp"
+#include "sglevelmatrix.hpp"
+#include "sgexpectationcache.hpp"
+#include "sghullindex.hpp"
+
+//! Counts of actions skipped by SGSolver_MaxMinMax
+/*! robustOptimizePolicy and sensitivity compute a cheap bound on what
+    each action can achieve and skip the actions whose bound cannot
+    beat the best found so far. These counters record how often that
+    happens, how the active actions grow when SG::ACTIVESET is true,
+    and how often policy iteration cycles. */
+struct SGPruningStats
+{
+  long policyActions; /*!< Actions considered by
+                         robustOptimizePolicy, summed over sweeps. */
+  long policyHullPruned; /*!< Of those, skipped because the best
+                            stage payoff in their group was
+                            available. */
+  long policyBoundPruned; /*!< Of those, skipped because of their
+                             upper bound. */
+  long sensitivityActions; /*!< Actions considered by sensitivity. */
+  long sensitivityBoundPruned; /*!< Of those, skipped because of
+                                  their lower bound on the
+                                  indifference level. */
+  long pricingPasses; /*!< Calls to
+                         SGSolver_MaxMinMax::priceActions. */
+  long actionsActivated; /*!< Actions added to the active actions by
+                            pricing. */
+  long arcsResweeps; /*!< Arcs swept again because pricing added an
+                        action on them. */
+  long arcsRestarts; /*!< Arcs of a parallel sweep swept again from
+                        the last policy of the previous arc. */
+  long policyCalls; /*!< Calls to robustOptimizePolicy. */
+  long policyPasses; /*!< Passes of policy iteration in those
+                        calls. */
+  long policyCycles; /*!< Calls to robustOptimizePolicy in which a
+                        policy repeated. */
+  long policyCyclesResolved; /*!< Of those, calls in which the
+                                anti-cycling rule reached a policy
+                                with no improvement. */
+
+  //! Constructor
+  SGPruningStats() { reset(); }
+  //! Adds the counters of other.
+  SGPruningStats & operator+=(const SGPruningStats & other)
+  {
+    policyActions += other.policyActions;
+    policyHullPruned += other.policyHullPruned;
+    policyBoundPruned += other.policyBoundPruned;
+    sensitivityActions += other.sensitivityActions;
+    sensitivityBoundPruned += other.sensitivityBoundPruned;
+    pricingPasses += other.pricingPasses;
+    actionsActivated += other.actionsActivated;
+    arcsResweeps += other.arcsResweeps;
+    arcsRestarts += other.arcsRestarts;
+    policyCalls += other.policyCalls;
+    policyPasses += other.policyPasses;
+    policyCycles += other.policyCycles;
+    policyCyclesResolved += other.policyCyclesResolved;
+    return *this;
+  }
+  //! Sets all counters to zero.
+  void reset()
+  {
+    policyActions = policyHullPruned = policyBoundPruned = 0;
+    sensitivityActions = sensitivityBoundPruned = 0;
+    pricingPasses = actionsActivated = arcsResweeps = arcsRestarts = 0;
+    policyCalls = policyPasses = 0;
+    policyCycles = policyCyclesResolved = 0;
+  }
+}; // SGPruningStats
 
 //! Class for solving stochastic games
 /*! This class implements the max-min-max algorithm of Abreu, Brooks,
@@ -46,6 +118,8 @@ private:
 
   //! SGEnv object to hold parameters
   const SGEnv & env;
+  //! Copy of the parameters of env, taken by initialize().
+  SGEnvSnapshot tol;
   //! Constant reference to the game to be solved.
   const SGGame & game; 
   //! SGSolution object used by SGApprox to store data.
@@ -63,20 +137,277 @@ private:
                                             to be played in
                                             equilibrium in the game. */
   const vector< vector<SGPoint> > & payoffs; /*!< Constant reference to payoffs in the game. */
-  const vector< vector< vector<double> > > & probabilities; /*!< Constant reference to transition probabilities in the game. */
   const vector< vector<int> > numActions; /*!< Number of actions in the game. */
   const vector< int > numActions_totalByState; /*!< Total number of actions in each state. */
 
-  list<SGPoint> directions; /*!< List of directions in which the algorithm bounds payoffs. */
-  list< vector<double> > levels; /*!< List of optimal levels attained in the corresponding directions. */
+  SGLevelMatrix levels; /*!< Directions in which the algorithm bounds
+                            payoffs, and the optimal levels attained
+                            in those directions. */
   SGTuple threatTuple; /*!< The current threat payoffs. */
-  vector< list<SGAction_MaxMinMax> > actions; /*!< Actions that can still be played. */
+  vector< vector<SGAction_MaxMinMax> > actions; /*!< Actions that can
+                                                   still be played,
+                                                   indexed by
+                                                   SGActionID. */
+  vector<SGHullIndex> hulls; /*!< For each state, the hulls of the
+                               stage payoffs of actions that share a
+                               transition row. Rebuilt by
+                               eraseUnsupportableActions. */
+  vector< vector<SGActionID> > activeActions; /*!< For each state, the
+                                                 increasing IDs of the
+                                                 actions used by the
+                                                 sweep in iterate()
+                                                 when SG::ACTIVESET is
+                                                 true. Reset by
+                                                 seedActiveActions at
+                                                 the start of each
+                                                 revolution. */
+
+  //! The optimal policy in a direction of a sweep
+  /*! Actions are identified by their index in the game, since the
+      SGActionIDs change when actions are erased. */
+  struct SweepPolicy
+  {
+    SGPoint dir; /*!< The direction. */
+    vector<int> actions; /*!< The action in each state. */
+    vector<SG::Regime> regimes; /*!< The regime in each state. */
+  };
+  vector<SweepPolicy> lastPolicies; /*!< The optimal policies in the
+                                       directions of the last
+                                       revolution of iterate(), in
+                                       clockwise order from due
+                                       north. Used to seed the next
+                                       revolution, whether or not
+                                       iterations are stored. */
   
   const SGPoint dueEast = SGPoint(1.0,0.0); /*!< The direction due east. */
   const SGPoint dueNorth = SGPoint(0.0,1.0); /*!< The direction due north. */
 
   int numIter; /*!< The number of iterations computed thus far. */
   double errorLevel; /*!< The current error level. */
+
+  mutable SGPolicyEvaluator evaluator; /*!< Solves for the payoffs and
+                                          penalties of a policy. */
+  mutable SGPruningStats pruningStats; /*!< Actions skipped by
+                                          robustOptimizePolicy and
+                                          sensitivity. Reset by
+                                          initialize(). */
+
+  std::shared_ptr<SGThreadPool> threadPool; /*!< Threads for the
+                                              trimming stage and the
+                                              parallel sweep. Created
+                                              by initialize(). */
+
+  //! Recalculates minimum IC payoffs and trims all actions
+  /*! Resets the trimmed points of each action and intersects them
+      with the half spaces in levels. Actions
+      are independent, so they are processed in parallel on
+      threadPool, and the result does not depend on the number of
+      threads. If update is true, also calls updateTrim on each
+      action. */
+  void trimActions(bool update);
+
+  //! Erases the actions that are not supportable
+  /*! Rebuilds the hull index of every state that lost actions. If
+      rebuild is true, rebuilds all of them. */
+  void eraseUnsupportableActions(bool rebuild = false);
+
+  //! Resets the active actions to those of lastPolicies
+  /*! Each state keeps its first action and the actions played in it
+      by the optimal policies of the last revolution. Does nothing if
+      lastPolicies is empty. */
+  void seedActiveActions();
+
+  //! Replaces the directions of solve_fixed with a finer set
+  /*! The new directions are numDirections evenly spaced directions
+      starting due east. The level of a new direction \f$d\f$ that
+      lies between the adjacent old directions \f$d_1\f$ and
+      \f$d_2\f$, written as \f$d=a d_1+b d_2\f$ with \f$a,b\ge
+      0\f$, is \f$a l_1+b l_2\f$, which bounds \f$d\cdot v\f$ for
+      every \f$v\f$ in both old half spaces. The approximation is
+      therefore still an outer bound. A new direction that coincides
+      with an old one keeps its level. */
+  void refineDirections(int numDirections);
+
+  //! A range of directions in the sweep of iterate()
+  /*! pivot is optimal in the directions from dir clockwise to
+      endDir, which are at most 90 degrees apart. */
+  struct SweepArc
+  {
+    SGPoint dir; /*!< First direction of the arc. */
+    SGPoint endDir; /*!< Last direction of the arc. */
+    SGTuple pivot; /*!< The optimal pivot on the arc. */
+    vector<double> penalties; /*!< The penalties of pivot. */
+  };
+
+  //! Mutable state used by the sweep
+  /*! The serial sweep and the public methods use
+      SGSolver_MaxMinMax::evaluator and
+      SGSolver_MaxMinMax::pruningStats. Each arc of a parallel sweep
+      has its own, so that the arcs share no mutable state. */
+  struct SweepContext
+  {
+    SGPolicyEvaluator & evaluator; /*!< Evaluates the policies. */
+    SGPruningStats & stats; /*!< Counts the actions skipped. */
+  };
+
+  //! The result of sweeping an arc of directions
+  struct SweepSegment
+  {
+    SGLevelMatrix levels; /*!< The directions and levels, in
+                             clockwise order. */
+    vector<SGStep> steps; /*!< The steps, if iterations are
+                             stored. */
+    vector<SweepArc> arcs; /*!< The range of each pivot, if the sweep
+                              uses the active actions. */
+    SGTuple threatTuple; /*!< The threat tuple, raised where the arc
+                            crosses due west or due south. */
+    vector<SweepPolicy> policies; /*!< The optimal policy in each
+                                     direction. */
+    bool capped; /*!< True if sensitivity found no indifference
+                    direction in the last step, which then ends a
+                    quarter turn after it starts unless endDir comes
+                    first. */
+  };
+
+  //! Initial policy for dir in a sweep
+  /*! Copies the policy in the direction of lastPolicies closest to
+      dir. If closest is a valid index, the search starts there and
+      moves clockwise, which is how a sweep moves, and otherwise it
+      scans all of lastPolicies. closest is set to the index
+      found. A state whose action has since been erased gets the
+      first remaining action and the non-binding regime. Returns
+      false, with that policy in every state, if lastPolicies is
+      empty. */
+  bool seedPolicy(const SGPoint & dir, int & closest,
+		  vector<SGActionID> & actionTuple,
+		  vector<SG::Regime> & regimeTuple) const;
+
+  //! Converts a recorded policy to action IDs and regimes
+  /*! A state whose action has since been erased gets the first
+      remaining action and the non-binding regime. */
+  void unpackPolicy(const SweepPolicy & policy,
+		    vector<SGActionID> & actionTuple,
+		    vector<SG::Regime> & regimeTuple) const;
+
+  //! Raises threats where a step of the sweep passes a cardinal direction
+  /*! If the step from currDir to newDir passes due west or due
+      south, raises the corresponding coordinate of threats to that
+      of the current threat tuple or of pivot plus its penalty,
+      whichever is larger. Returns true if the step passes due north
+      instead. */
+  bool updateThreats(const SGPoint & currDir, const SGPoint & newDir,
+		     const SGTuple & pivot, const vector<double> & penalties,
+		     SGTuple & threats) const;
+
+  //! Appends one segment for each arc of segment to pieces
+  /*! Requires the arcs of segment, which are only recorded when the
+      sweep uses the active actions. */
+  void splitSegment(const SweepSegment & segment,
+		    vector<SweepSegment> & pieces) const;
+
+  //! Sweeps clockwise through an arc of directions
+  /*! Alternates between robustOptimizePolicy and sensitivity. In
+      each direction, robustOptimizePolicy starts from the policy
+      given by seedPolicy if its actions differ from the current
+      ones. In startDir, it starts from startPolicy instead if that
+      is not NULL, which is how iterate() continues the last step of
+      the previous arc of a parallel sweep. If endDir is NULL, stops
+      after passing due north. This is how iterate() sweeps the
+      whole circle from due north by default, and how it sweeps the
+      last arc of a parallel sweep. Otherwise stops at endDir, which
+      must be less than half a turn clockwise from startDir. The last
+      direction is then endDir itself, since the pivot is optimal in
+      every direction up to the next one.
+
+      Specialized on whether the inner approximation is being
+      computed. */
+  template<bool doInner>
+  void sweep(const SGPoint & startDir,
+	     const SGPoint * endDir,
+	     const SweepPolicy * startPolicy,
+	     SweepSegment & segment,
+	     SweepContext & context,
+	     const vector< vector<SGActionID> > * activeActions) const;
+
+  //! Calls the specialization of sweep
+  void sweep(const SGPoint & startDir,
+	     const SGPoint * endDir,
+	     const SweepPolicy * startPolicy,
+	     SweepSegment & segment,
+	     SweepContext & context,
+	     const vector< vector<SGActionID> > * activeActions) const;
+
+  //! Adds the inactive actions that may improve on a sweep
+  /*! For each arc, an action that is not in activeActions is added
+      if robustOptimizePolicy could offer it on the arc or
+      sensitivity could cut the arc with it. The non-binding payoff
+      must come within the tolerances of the pivot's level, and the
+      binding payoff close enough that lexComp could let the
+      non-binding regime through, unless lexAbove could find that
+      the binding constraint does not bind. Otherwise the binding
+      payoff must come within the tolerances of the pivot's level,
+      and the non-binding payoff within the 1e-6 that sensitivity
+      allows. The levels are affine in the weight on normDir with
+      which sensitivity parametrizes the arc, so each test fails on
+      the whole arc if it fails at both ends. Sets added[k]
+      to true if an action was added on arcs[k], and returns the
+      number of actions added. If it is zero, no action outside
+      activeActions would have changed the sweep. */
+  int priceActions(const vector<SweepArc> & arcs, vector<bool> & added);
+
+  //! Largest level in dir of the action's binding continuation values
+  /*! Returns -numeric_limits<double>::max() if the action has no
+      binding points. */
+  double maxBindingLevel(const SGAction_MaxMinMax & action,
+			 const SGPoint & dir) const;
+
+  //! Passes the policy to the evaluator
+  void setEvaluatorPolicy(SGPolicyEvaluator & evaluator,
+			  const vector<SGActionID>  & actionTuple,
+			  const vector<SG::Regime> & regimeTuple) const;
+
+  //! Optimizes the policy for the given direction
+  /*! Specialized on whether the inner approximation is being
+      computed. When doInner is false, the penalties are identically
+      zero and the penalty arithmetic is compiled out. */
+  template<bool doInner>
+  void robustOptimizePolicy(SGTuple & pivot,
+			    vector<double> & penalties,
+			    vector<SGActionID> & actionTuple,
+			    vector<SG::Regime> & regimeTuple,
+			    vector<bool> & bestAPSNotBinding,
+			    SGTuple & bestBindingPayoffs,
+			    const SGPoint currDir,
+			    const vector< vector<SGAction_MaxMinMax> > & actions,
+			    const vector< vector<SGActionID> > * activeActions,
+			    SweepContext & context) const;
+
+  //! Find the next clockwise direction at which the optimal tuple
+  //! changes
+  /*! Specialized on whether the inner approximation is being
+      computed. */
+  template<bool doInner>
+  double sensitivity(const SGTuple & pivot,
+		     const vector<double> & penalties,
+		     const vector<SGActionID> & actionTuple,
+		     const vector<SG::Regime> & regimeTuple,
+		     const SGPoint currDir,
+		     const vector< vector<SGAction_MaxMinMax> > & actions,
+		     const vector< vector<SGActionID> > * activeActions,
+		     SweepContext & context) const;
+
+  //! Switches regimes from binding to non-binding to minimize levels
+  /*! Specialized on whether the inner approximation is being
+      computed. */
+  template<bool doInner>
+  void minimizeRegimes(SGTuple & pivot,
+		       vector<double> & penalties,
+		       const vector<SGActionID> & actionTuple,
+		       vector<SG::Regime> & regimeTuple,
+		       const SGPoint & dir,
+		       const SGTuple & bestBindingPayoffs,
+		       const vector<bool> & bestAPSNotBinding,
+		       SweepContext & context) const;
   
 public:
   //! Default constructor
@@ -96,7 +427,15 @@ public:
       generates it until one of the stopping criteria have been
       met. Stores progress in the data member. 
 
-      Fixed directions. */
+      Fixed directions. If SG::COARSEDIRECTIONS is positive, the
+      first iterations use fewer directions, which are doubled with
+      refineDirections whenever the error level falls below the
+      distance between a set of the current width and the polygon of
+      its tangent half spaces in that many directions. The last
+      iterations always use the final 200 directions, and the solve
+      only ends on a revolution at that resolution which started from
+      levels computed at that resolution, not from the interpolated
+      levels of refineDirections. */
   void solve_fixed();
 
   //! Solve routine
@@ -108,12 +447,22 @@ public:
   void solve();
 
   //! One iteration of the endogenous algorith.
-  /*! Return the new error level. */
+  /*! Return the new error level. If SG::SWEEPSEGMENTS is positive,
+      the circle is split into arcs between seed directions, starting
+      due north, and the arcs are swept in parallel on the thread
+      pool. An arc that does not start with the policy the serial
+      sweep would carry into it is swept again from the last step of
+      the previous arc. The results are joined in clockwise order, so
+      that the directions are those of the serial sweep. */
   double iterate();
 
   //! Compute approximate Hausdorff distance
-double pseudoHausdorff(const list<SGPoint> & newDirections,
-					   const list<vector<double> > & newLevels) const;
+  /*! Returns the largest distance from a half space in newLevels to
+      the nearest half space in levels, where the distance is the sup
+      norm distance between the directions plus the largest
+      difference in levels across states. See
+      SGLevelMatrix::pseudoHausdorff. */
+  double pseudoHausdorff(const SGLevelMatrix & newLevels) const;
 
   //! Initializes the solve routines
   void initialize();
@@ -121,33 +470,45 @@ double pseudoHausdorff(const list<SGPoint> & newDirections,
   std::string progressString() const;
 
   //! Optimizes the policy for the given direction
+  /*! Calls the specialization for the inner or the outer
+      approximation, depending on SG::SUBGENFACTOR. If activeActions
+      is not NULL, only the actions it lists for each state are
+      offered. */
   void robustOptimizePolicy(SGTuple & pivot,
 			    vector<double> & penalties,
-			    vector<SGActionIter> & actionTuple,
+			    vector<SGActionID> & actionTuple,
 			    vector<SG::Regime> & regimeTuple,
 			    vector<bool> & bestAPSNotBinding,
 			    SGTuple & bestBindingPayoffs,
 			    const SGPoint currDir,
-			    const vector<list<SGAction_MaxMinMax> > & actions) const;
+			    const vector< vector<SGAction_MaxMinMax> > & actions,
+			    const vector< vector<SGActionID> > * activeActions = NULL) const;
 
   //! Find the next clockwise direction at which the optimal tuple
   //! changes
+  /*! Calls the specialization for the inner or the outer
+      approximation. If activeActions is not NULL, only the current
+      actions and the actions it lists for each state are checked. */
   double sensitivity(const SGTuple & pivot,
 		     const vector<double> & penalties,
-		     const vector<SGActionIter> & actionTuple,
+		     const vector<SGActionID> & actionTuple,
 		     const vector<SG::Regime> & regimeTuple,
 		     const SGPoint currDir,
-		     const vector<list<SGAction_MaxMinMax> > & actions) const;
+		     const vector< vector<SGAction_MaxMinMax> > & actions,
+		     const vector< vector<SGActionID> > * activeActions = NULL) const;
 
-  //! Converts a policy function to a payoff function using bellman iteration
+  //! Converts a policy function to a payoff function
+  /*! Solves for the fixed point exactly using
+      SGSolver_MaxMinMax::evaluator. Payoffs in binding states are
+      held fixed. */
   void policyToPayoffs(SGTuple & pivot,
-		       const vector<SGActionIter>  & actionTuple,
+		       const vector<SGActionID>  & actionTuple,
 		       const vector<SG::Regime> & regimeTuple) const;
 
-  //! Converts a policy function to the associated penalties using
-  //! bellman iteration, when computing inner approximation
+  //! Converts a policy function to the associated penalties, when
+  //! computing inner approximation
   void policyToPenalties(vector<double> & penalties,
-			 const vector<SGActionIter>  & actionTuple,
+			 const vector<SGActionID>  & actionTuple,
 			 const vector<SG::Regime> & regimeTuple) const;
 
   //! Lexicographic comparison of points
@@ -161,22 +522,24 @@ double pseudoHausdorff(const list<SGPoint> & newDirections,
 	       const SGPoint & dir ) const;
 
   //! Computes  the best binding payoff for an action
-  bool computeBestBindingPayoff(const SGActionIter ait,
+  bool computeBestBindingPayoff(const SGAction_MaxMinMax & action,
 				int & bestBindingPlayer,
 				int & bestBindingPoint,
 				const SGPoint & dir) const;
 
   //! Update best binding payoffs and check if best APS is binding
-  void updateBestBinding(const vector<SGActionIter> & actionTuple,
+  void updateBestBinding(const vector<SGActionID> & actionTuple,
 			 const vector<SG::Regime> & regimeTuple,
 			 const SGPoint & dir,
 			 SGTuple & bestBindingPayoffs,
 			 vector<bool> & bestAPSNotBinding) const;
 
   //! Switches regimes from binding to non-binding to minimize levels
+  /*! Calls the specialization for the inner or the outer
+      approximation. */
   void minimizeRegimes(SGTuple & pivot,
 		       vector<double> & penalties,
-		       const vector<SGActionIter> & actionTuple,
+		       const vector<SGActionID> & actionTuple,
 		       vector<SG::Regime> & regimeTuple,
 		       const SGPoint & dir,
 		       const SGTuple & bestBindingPayoffs,
@@ -186,6 +549,11 @@ double pseudoHausdorff(const list<SGPoint> & newDirections,
   /*! Returns true if a is above b or a is parallel to b. */
   bool lexAbove(const SGPoint & a, const SGPoint & b ) const;
   
+  //! Returns the counts of actions skipped since initialize()
+  const SGPruningStats & getPruningStats() const { return pruningStats; }
+  //! Returns the number of iterations since initialize()
+  int getNumIterations() const { return numIter; }
+
   //! Returns a constant reference to the SGSolution_MaxMinMax object storing the
   //! output of the computation.
   const SGSolution_MaxMinMax& getSolution() const {return soln;}
@@ -30,6 +30,12 @@
 #include "sgexception.hpp"
 #include "sgsolution_maxminmax.hpp"
 #include "sgedgepolicy.hpp"
+#include "sgpolicyevaluator.hpp"
+#include "sgthreadpool.hpp"
+#include "sglevelmatrix.hpp"
+#include "sgexpectationcache.hpp"
+#include "sgdirectionindex.hpp"
+#include "sggeodesicmesh.hpp"
 
 //! Class for solving stochastic games
 /*! This class implements the max-min-max algorithm of Abreu, Brooks,
@@ -47,6 +53,8 @@ private:
 
   //! SGEnv object to hold parameters
   const SGEnv & env;
+  //! Copy of the parameters of env, taken by initialize().
+  SGEnvSnapshot tol;
   //! Constant reference to the game to be solved.
   const SGGame & game; 
   //! SGSolution object used by SGApprox to store data.
@@ -64,16 +72,34 @@ private:
                                             to be played in
                                             equilibrium in the game. */
   const vector< vector<SGPoint> > & payoffs; /*!< Constant reference to payoffs in the game. */
-  const vector< vector< vector<double> > > & probabilities; /*!< Constant reference to transition probabilities in the game. */
   const vector< vector<int> > numActions; /*!< Number of actions in the game. */
   const vector< int > numActions_totalByState; /*!< Total number of actions in each state. */
 
-  list<SGPoint> directions; /*!< List of directions in which the algorithm bounds payoffs. */
-  list< vector<double> > levels; /*!< List of optimal levels attained in the corresponding directions. */
+  SGLevelMatrix levels; /*!< Directions in which the algorithm bounds
+                            payoffs, and the optimal levels attained
+                            in those directions. */
+
+  //! The optimal policy in a direction
+  /*! Actions are identified by their index in the game, since the
+      SGActionIDs change when actions are erased. */
+  struct DirectionPolicy
+  {
+    SGTuple pivot; /*!< The payoffs of the policy. */
+    vector<int> actions; /*!< The action in each state. Empty if the
+                            direction has not been optimized yet. */
+    vector<SG::Regime> regimes; /*!< The regime in each state. */
+  };
+  vector<DirectionPolicy> policies; /*!< The policy found by the last
+                                       iteration in each direction of
+                                       levels, in the same order. Used
+                                       to warm start iterate(). */
 
   list<SGPoint> threatDirections;
   SGTuple threatTuple; /*!< The current threat payoffs. */
-  vector< list<SGAction_MaxMinMax> > actions; /*!< Actions that can still be played. */
+  vector< vector<SGAction_MaxMinMax> > actions; /*!< Actions that can
+                                                   still be played,
+                                                   indexed by
+                                                   SGActionID. */
   
   const SGPoint dueEast = SGPoint(1.0,0.0); /*!< The direction due east. */
   const SGPoint dueNorth = SGPoint(0.0,1.0); /*!< The direction due north. */
@@ -86,8 +112,92 @@ private:
 
   int numRedundDirs; /*!< Number of redundant directions dropped so far. */
   int numEndogDirs; /*!< Number of endogenous directions added so far. */
+  int numRefinedDirs; /*!< Number of directions added by
+                         refineDirections so far. */
+
+  SGGeodesicMesh mesh; /*!< Mesh of directions, used when
+                          SG::ADAPTIVEDIRECTIONS is true. */
+  int maxMeshDepth; /*!< Triangles of mesh at this depth are not
+                       refined further. */
+  vector<int> dirVertices; /*!< The vertex of mesh that is each
+                              direction of levels, in the same order,
+                              or -1 for directions that are not in the
+                              mesh. */
 
   bool debugMode; /*!< Indicator for whether the program is being debugged. */
+
+  mutable SGPolicyEvaluator evaluator; /*!< Solves for the payoffs of
+                                          a policy. */
+
+  std::shared_ptr<SGThreadPool> threadPool; /*!< Threads for the
+                                              trimming stage. Created by
+                                              initialize(). */
+
+  //! Recalculates minimum IC payoffs and trims all actions
+  /*! Resets the trimmed points of each action and intersects them
+      with the half spaces in levels, visited in the given order, and
+      then, if trimThreats is true, with the threat
+      directions. Sets redundant[d] to false if direction d trimmed
+      some action. Actions are processed in parallel on threadPool,
+      and the result does not depend on the number of threads. */
+  void trimActions(const vector<int> & order,
+		   vector<bool> & redundant,
+		   bool trimThreats);
+
+  //! Adds directions where the optimal policies change
+  /*! Refines the leaf triangles of mesh whose corners have different
+      optimal policies. With corner directions \f$d_i\f$, levels
+      \f$l_i\f$, and payoffs \f$v_i\f$, and \f$c=\sum_i d_i/n\f$
+      the centroid direction with \f$n=\|\sum_i d_i\|\f$, the half
+      spaces of the corners bound payoffs in direction \f$c\f$ by
+      \f$\sum_i l_i(s)/n\f$, while the corners attain \f$\max_i
+      v_i(s)\cdot c\f$. The difference, maximized over states, is the
+      gap between the outer and inner approximations over the
+      triangle, and measures the curvature of the support function
+      there. Triangles are refined in decreasing order of the gap.
+
+      A triangle is only refined if the gap exceeds both SG::ERRORTOL
+      and the movement of the levels in the current iteration, if
+      none of its corners has been dropped as redundant, if it has
+      not been coarsened before, and if it is shallower than
+      maxMeshDepth. The new directions are optimized from the policy
+      of the corner with the highest payoffs in that direction and
+      added at the end of levels, as long as there are at most
+      maxDirections. Returns the number of directions added. */
+  int refineDirections(const int maxDirections);
+
+  //! Coarsens the patches of mesh that were dropped as redundant
+  /*! Merges the children of the refined triangles whose children are
+      leaves and whose edge midpoints have all been dropped from
+      levels. */
+  void coarsenDirections();
+
+  //! Optimizes the policy for the given direction with evaluator
+  /*! Used by the parallel direction loop of iterate(), in which each
+      block of directions has its own evaluator. Returns false if
+      policy iteration hit tol.maxPolicyIterations, and prints
+      nothing, so that the caller can report it outside the worker
+      threads. */
+  bool optimizePolicy(SGTuple & pivot,
+		      vector<SGActionID> & actionTuple,
+		      vector<SG::Regime> & regimeTuple,
+		      const SGPoint & currDir,
+		      const vector< vector<SGAction_MaxMinMax> > & actions,
+		      SGPolicyEvaluator & evaluator) const;
+
+  //! Sets the policy to the one recorded in a DirectionPolicy
+  /*! Actions that have since been erased are replaced with the first
+      action in binding regime. Does nothing if the policy has not
+      been recorded yet. */
+  void loadPolicy(SGTuple & pivot,
+		  vector<SGActionID> & actionTuple,
+		  vector<SG::Regime> & regimeTuple,
+		  const DirectionPolicy & policy) const;
+
+  //! Records the policy in a DirectionPolicy
+  DirectionPolicy recordPolicy(const SGTuple & pivot,
+			       const vector<SGActionID> & actionTuple,
+			       const vector<SG::Regime> & regimeTuple) const;
   
 public:
   //! Default constructor
@@ -107,7 +217,20 @@ public:
       generates it until one of the stopping criteria have been
       met. Stores progress in the data member. 
 
-      Drops redundant directions and adds new face directions. */
+      Drops redundant directions and adds new face directions. 
+
+      If SG::ADAPTIVEDIRECTIONS is true, starts instead from the
+      icosahedron, refined uniformly while that uses at most a
+      quarter of numDirsApprox directions, and adds the remaining
+      directions with refineDirections. Patches can be refined down
+      to the resolution of the first uniform refinement with at least
+      numDirsApprox directions, so up to the direction budget, the
+      directions where the optimal policies change can be as dense as
+      in the uniform solve. Redundant mesh directions are dropped as
+      usual, and patches whose refinement was dropped are merged
+      again by coarsenDirections. Random face directions, if
+      addEndogenous is true, only use the directions that are left
+      after refinement. */
   void solve(const int numDirsApprox = 200,
 	     const bool dropRedundant = true,
 	     const bool addEndogenous = true);
@@ -125,7 +248,18 @@ public:
   double iterate_endogenous();
 
   //! One iteration of the algorithm.
-  /*! Return the new error level. */
+  /*! Optimizes the policy in each direction in parallel on
+      threadPool. Each direction starts from its own policy in the
+      last iteration, or, in its first iteration, from the policy of
+      the previous direction in its block of directions. The blocks
+      have a fixed size, so the result does not depend on the number
+      of threads. 
+
+      New face directions are found from random starting directions,
+      each of which starts from the policy of the nearest existing
+      direction. Faces within 1e-5 of an existing direction are
+      skipped. Both lookups use an SGDirectionIndex. Return the new
+      error level. */
   double iterate(const int maxDirections,
 		       const bool dropRedundant,
 		       const bool addEndogenous);
@@ -136,11 +270,12 @@ public:
   std::string progressString() const;
   
   //! Optimizes the policy for the given direction
+  /*! Uses SGSolver_MaxMinMax_3Player::evaluator. */
   void optimizePolicy(SGTuple & pivot,
-		      vector<SGActionIter> & actionTuple,
+		      vector<SGActionID> & actionTuple,
 		      vector<SG::Regime> & regimeTuple,
 		      const SGPoint & currDir,
-		      const vector<list<SGAction_MaxMinMax> > & actions) const;
+		      const vector< vector<SGAction_MaxMinMax> > & actions) const;
 
   //! Compute all policies that are at least as high as the given
   //! pivot. Returns false if there is a strict improvement, and true
@@ -148,7 +283,7 @@ public:
   bool computeOptimalPolicies(SGProductPolicy & optPolicies,
 			      const SGTuple & pivot,
 			      const SGPoint & currDir,
-			      const vector<list<SGAction_MaxMinMax> > & actions) const;
+			      const vector< vector<SGAction_MaxMinMax> > & actions) const;
   
   //! Find the next clockwise direction at which the optimal tuple
   //! changes
@@ -156,12 +291,20 @@ public:
 		     const SGTuple & pivot,
 		     const SGPoint & currDir,
 		     const SGPoint & newDir,
-		     const vector<list<SGAction_MaxMinMax> > & actions) const;
+		     const vector< vector<SGAction_MaxMinMax> > & actions) const;
 
-  //! Converts a policy function to a payoff function using bellman iteration
+  //! Converts a policy function to a payoff function
+  /*! Solves for the fixed point exactly using
+      SGSolver_MaxMinMax_3Player::evaluator. Payoffs in binding states
+      are held fixed. */
   void policyToPayoffs(SGTuple & pivot,
-		       const vector<SGActionIter>  & actionTuple,
+		       const vector<SGActionID>  & actionTuple,
 		       const vector<SG::Regime> & regimeTuple) const;
+  //! Converts a policy function to a payoff function with evaluator
+  void policyToPayoffs(SGTuple & pivot,
+		       const vector<SGActionID>  & actionTuple,
+		       const vector<SG::Regime> & regimeTuple,
+		       SGPolicyEvaluator & evaluator) const;
 
   //! Returns a constant reference to the SGSolution_MaxMinMax object storing the
   //! output of the computation.
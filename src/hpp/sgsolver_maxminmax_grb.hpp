@@ -68,7 +68,8 @@ private:
 
   //! Game elements
   const vector< vector< SGPoint> > & payoffs;
-  const vector< vector< vector<double> > > & prob;
+  //! Dense copy of the transitions, which SGGame may store sparsely
+  const vector< vector< vector<double> > > prob;
   const vector< vector<int> > & numActions;
   const vector< int > & numActions_total;
   const int numStates;
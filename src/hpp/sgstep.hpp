@@ -48,29 +48,18 @@ public:
   {} // default constructor
 
   //! Constructor
-  SGStep(const vector< list<SGAction_MaxMinMax>::const_iterator > & _actionTuple,
+  /*! The IDs in _actionTuple are the indices of the optimal actions
+      in the solver's action arrays, which are the arrays copied by
+      SGIteration_MaxMinMax at the start of the iteration. */
+  SGStep(const vector<SGActionID> & _actionTuple,
 	 const vector<SG::Regime> & _regimeTuple,
 	 const SGTuple & _pivot,
-	 const SGHyperplane & _hyperplane,
-	 const vector< list<SGAction_MaxMinMax> > & actions):
-    actionTuple (_actionTuple.size(),0),
+	 const SGHyperplane & _hyperplane):
+    actionTuple{_actionTuple},
     regimeTuple{_regimeTuple},
     pivot{_pivot},
     hyperplane{_hyperplane}
-  {
-    for (int state = 0; state < _actionTuple.size(); state++)
-      {
-	// Find the element of the actions array that corresponds to
-	// the optimal action
-	auto action = actions[state].cbegin();
-	while (action->getAction() != _actionTuple[state]->getAction()
-	       && action != actions[state].cend() )
-	  {
-	    actionTuple[state]++;
-	    ++action;
-	  }
-      }
-  } // Constructor
+  {} // Constructor
 
   // Get method for the pivot
   const SGTuple & getPivot() const {return pivot;}
@@ -0,0 +1,91 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+#ifndef _SGTHREADPOOL_HPP
+#define _SGTHREADPOOL_HPP
+
+#include "sgcommon.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+//! Persistent pool of worker threads
+/*! Runs loops of independent tasks in parallel. The threads are
+    created once, when the pool is constructed, and wait on a
+    condition variable between calls to parallelFor, so the pool can
+    be reused every iteration without paying for thread creation.
+
+    The thread that calls parallelFor also executes tasks. Tasks are
+    handed out dynamically, so callers must ensure that tasks write
+    only to their own data. Under that condition the result does not
+    depend on the number of threads.
+
+    Used by SGSolver_MaxMinMax and SGSolver_MaxMinMax_3Player.
+
+    \ingroup src
+ */
+class SGThreadPool
+{
+private:
+  vector<std::thread> workers; /*!< The worker threads. */
+  std::mutex mtx; /*!< Guards the state shared with the workers. */
+  std::condition_variable workReady; /*!< Signals a new loop or
+                                        shutdown. */
+  std::condition_variable workDone; /*!< Signals that all workers have
+                                       finished the current loop. */
+
+  const std::function<void(int)> * task; /*!< The body of the current
+                                            loop. */
+  int numTasks; /*!< Number of tasks in the current loop. */
+  std::atomic<int> nextTask; /*!< Index of the next task to hand out. */
+  int numActive; /*!< Number of workers still in the current loop. */
+  unsigned long generation; /*!< Incremented for every loop. */
+  bool stopping; /*!< True when the pool is being destroyed. */
+  std::exception_ptr error; /*!< First exception thrown by a task. */
+
+  //! Main loop of a worker thread.
+  void workerLoop();
+  //! Executes tasks until none are left.
+  void runTasks();
+
+public:
+  //! Constructor
+  /*! Creates a pool in which numThreads threads, including the
+      calling thread, execute tasks. If numThreads is zero, uses the
+      number of hardware threads. */
+  SGThreadPool(int numThreads);
+  //! Destructor
+  /*! Stops and joins the worker threads. */
+  ~SGThreadPool();
+
+  //! Returns the number of threads that execute tasks.
+  int size() const { return workers.size()+1; }
+
+  //! Runs task(i) for i=0,...,n-1 and waits for completion.
+  /*! If a task throws, the first exception is rethrown in the
+      calling thread after all tasks have finished. */
+  void parallelFor(int n, const std::function<void(int)> & task);
+}; // SGThreadPool
+
+#endif
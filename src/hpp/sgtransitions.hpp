@@ -0,0 +1,118 @@
+// This file is part of the SGSolve library for stochastic games
+// Copyright (C) 2019 Benjamin A. Brooks
+//
+// SGSolve free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// SGSolve is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+// Benjamin A. Brooks
+// ben@benjaminbrooks.net
+// Chicago, IL
+
+
+#ifndef _SGTRANSITIONS_HPP
+#define _SGTRANSITIONS_HPP
+
+#include "sgcommon.hpp"
+
+//! One row of sparse transition probabilities
+/*! Lists the nnz states that can be reached with positive
+    probability, in increasing order, together with their
+    probabilities. Points into an SGSparseTransitions object, so it
+    is only valid as long as that object is not modified. */
+struct SGTransitionRow
+{
+  int nnz; /*!< Number of states with positive probability. */
+  const int * states; /*!< The states, in increasing order. */
+  const double * probs; /*!< The corresponding probabilities. */
+};
+
+//! Transition probabilities in compressed sparse row form
+/*! For each state, the nonzero entries of the rows of transition
+    probabilities are stored one row after another in a single array,
+    and rowStart[s][a] gives the offset of the row for action a. The
+    columns index the same states as the rows. Used by SGGame in
+    place of the dense probabilities when most transitions are zero,
+    so that expectations cost time proportional to the number of
+    reachable states rather than the number of states.
+
+    \ingroup src
+ */
+class SGSparseTransitions
+{
+private:
+  vector< vector<int> > rowStart; /*!< rowStart[s][a] is the offset of
+                                     the row for action a in state
+                                     s. Has one more element than the
+                                     number of actions. */
+  vector< vector<int> > states; /*!< Column indices, by state. */
+  vector< vector<double> > probs; /*!< Nonzero probabilities, by
+                                     state. */
+
+public:
+  //! Default constructor
+  SGSparseTransitions() {}
+  //! Compresses dense transition probabilities
+  SGSparseTransitions(const vector< vector< vector<double> > > & dense);
+
+  //! Recompresses the rows for one state
+  void setState(int state, const vector< vector<double> > & dense);
+  //! Sets one probability.
+  /*! Inserts or erases the entry as needed. Costs time proportional
+      to the number of nonzero entries of state. */
+  void set(int state, int action, int newState, double prob);
+  //! Adds an absorbing state with one action at position.
+  /*! States from position on are shifted up by one. */
+  void insertState(int position);
+  //! Removes state, together with every transition into it.
+  void eraseState(int state);
+
+  //! Number of states.
+  int getNumStates() const { return rowStart.size(); }
+
+  //! Returns the row for action in state.
+  SGTransitionRow row(int state, int action) const
+  {
+    const int start = rowStart[state][action];
+    SGTransitionRow r = { rowStart[state][action+1]-start,
+			  states[state].data()+start,
+			  probs[state].data()+start };
+    return r;
+  }
+
+  //! Returns the probability of moving to newState.
+  double probability(int state, int action, int newState) const;
+  //! Uncompresses the rows for one state
+  vector< vector<double> > denseState(int state) const;
+  //! Uncompresses all of the rows
+  vector< vector< vector<double> > > dense() const;
+
+  //! Total number of nonzero probabilities
+  int nnz() const;
+  //! Fraction of the entries that are nonzero
+  double density() const;
+
+  //! Fraction of the entries of dense that are nonzero
+  static double density(const vector< vector< vector<double> > > & dense);
+
+  //! Serializes the rows using boost.
+  template<class Archive>
+  void serialize(Archive & ar, const unsigned int version)
+  {
+    ar & rowStart;
+    ar & states;
+    ar & probs;
+  }
+}; // SGSparseTransitions
+
+#endif
@@ -25,6 +25,7 @@
 #include "sgcommon.hpp"
 #include "sgpoint.hpp"
 #include "sgexception.hpp"
+#include "sgtransitions.hpp"
 
 //! Tuple of SGPoint objects
 /*! Essentially a vector of SGPoint objects that supports arithmetic
@@ -79,6 +80,14 @@ public:
       objects in the tuple using the weights in prob. */
   double expectation(const vector<double> & prob, int player) const;
 
+  //! Mathematical expectation over a sparse row
+  /*! Same as expectation(const vector<double>&), but only sums over
+      the states in row. */
+  SGPoint expectation(const SGTransitionRow & row) const;
+
+  //! Mathematical expectation over a sparse row for one player.
+  double expectation(const SGTransitionRow & row, int player) const;
+
   //! Returns the average of the points in the tuple.
   SGPoint average() const;
   //! Returns the average coordinate for a player in the tuple.
@@ -127,6 +136,9 @@ public:
   void erase(int start, int end);
   //! Adds an element at the location
   void emplace(int location,const SGPoint & point);
+  //! Changes the number of points
+  /*! Existing points up to the new size are kept. */
+  void resize(int newSize);
   //! Removes non-unique elements
   void unique(double tol);
   
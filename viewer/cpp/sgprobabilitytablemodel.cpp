@@ -37,8 +37,8 @@ QVariant SGProbabilityTableModel::data(const QModelIndex & index,
       assert(nextState < game->getNumStates());
       assert(state < game->getNumStates());
       
-      return QVariant(QString::number(game->getProbabilities()
-				      [state][action][nextState]));
+      return QVariant(QString::number(game->getProbability(state,action,
+							   nextState)));
     }
   else
     return QVariant();
@@ -81,6 +81,12 @@ SGSettingsHandler::SGSettingsHandler(QWidget * parent,
 		     new SGIntParamEdit(this,env,SG::TUPLERESERVESIZE));
   editLayout->addRow(QString("Store iterations:"),
 		     new SGIntParamEdit(this,env,SG::STOREITERATIONS));
+  editLayout->addRow(QString("Number of threads:"),
+		     new SGIntParamEdit(this,env,SG::NUMTHREADS));
+  editLayout->addRow(QString("Parallel sweep segments:"),
+		     new SGIntParamEdit(this,env,SG::SWEEPSEGMENTS));
+  editLayout->addRow(QString("Initial fixed directions:"),
+		     new SGIntParamEdit(this,env,SG::COARSEDIRECTIONS));
 
   // Construct and add boolean parameter edits.
   editLayout->addRow(QString("Merge tuples:"),
@@ -89,6 +95,10 @@ SGSettingsHandler::SGSettingsHandler(QWidget * parent,
 		     new SGBoolParamBox(this,env,SG::STOREACTIONS));
   editLayout->addRow(QString("Check sufficient conditions for containment:"),
 		     new SGBoolParamBox(this,env,SG::CHECKSUFFICIENT));
+  editLayout->addRow(QString("Active set of actions:"),
+		     new SGBoolParamBox(this,env,SG::ACTIVESET));
+  editLayout->addRow(QString("Adaptive 3-player directions:"),
+		     new SGBoolParamBox(this,env,SG::ADAPTIVEDIRECTIONS));
 
 
   mainLayout->addLayout(editLayout);
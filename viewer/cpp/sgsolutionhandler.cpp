@@ -243,8 +243,8 @@ void SGSolutionHandler::plotSolution()
              ++step)
         {
             SGPoint expPoint
-                    = step->getPivot().expectation(soln.getGame().getProbabilities()
-                                                   [state][action]);
+                    = soln.getGame().expectation(step->getPivot(),
+                                                 state,action);
             expSetX[tupleC] = expPoint[0];
             expSetY[tupleC] = expPoint[1];
             expSetT[tupleC] = tupleC;
@@ -275,8 +275,8 @@ void SGSolutionHandler::plotSolution()
                  ++step)
             {
                 SGPoint expPoint
-                        = step->getPivot().expectation(soln.getGame().getProbabilities()
-                                                       [state][action]);
+                        = soln.getGame().expectation(step->getPivot(),
+                                                     state,action);
                 prevExpSetX[tupleC] = expPoint[0];
                 prevExpSetY[tupleC] = expPoint[1];
                 prevExpSetT[tupleC] = tupleC;
@@ -299,8 +299,8 @@ void SGSolutionHandler::plotSolution()
         // if (controller->getPlotMode() == SGPlotController::Directions)
         // 	{
         // Non-binding direction
-        SGPoint expPivot = currentStep.getPivot().expectation(soln.getGame().getProbabilities()
-                                                              [state][action]);
+        SGPoint expPivot = soln.getGame().expectation(currentStep.getPivot(),
+                                                      state,action);
 
         SGPoint nonBindingPayoff = (1-delta)*stagePayoffs + delta*expPivot;
 
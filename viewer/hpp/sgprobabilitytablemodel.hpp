@@ -57,7 +57,7 @@ public:
   //! Reimplements the data method
   /*! Retrieves the probability of going to nextState from state, when
       the action profile indicated by index is played. Retrieves the
-      data using SGGame::getProbabilities. */
+      data using SGGame::getProbability. */
   QVariant data(const QModelIndex & index,
 		int role) const Q_DECL_OVERRIDE;
     